@@ -2,6 +2,7 @@
 #define INSTANALOG_H
 
 #include "visuinstrument.h"
+#include <QCache>
 
 class InstAnalog : public VisuInstrument
 {
@@ -23,6 +24,17 @@ class InstAnalog : public VisuInstrument
 
         static constexpr double PI = 3.141592653589793238463;
         static constexpr double STEPS_IN_DEGREE = 16;
+        static const int NEEDLE_CACHE_BYTES = 32 * 1024 * 1024;   // shared by all analog instruments
+
+        /**
+         * @brief The NeedleSprite struct
+         * Pointer rasterized at one angle step, and its position in instrument.
+         */
+        struct NeedleSprite
+        {
+            VisuLayer layer;
+            QPoint origin;
+        };
 
         // configuration properties
         QColor cColorCircle;
@@ -65,6 +77,10 @@ class InstAnalog : public VisuInstrument
         double mEndPointY;
         quint16 mCenterX;
         quint16 mCenterY;
+        QPolygonF mPointer;     // pointer for current value
+        qint64 mPointerStep;    // pointer angle in steps of about one pixel at its tip
+        QByteArray mNeedleKey;  // identifies pointer shape, angle step is appended
+        NeedleSprite mNeedle;   // sprite for current value
 
         void renderOutterCircle(QPainter* painter);
         void renderMajorDivision(QPainter* painter);
@@ -83,11 +99,18 @@ class InstAnalog : public VisuInstrument
         void renderDivision(QPainter* painter, int divisionCnt);
         void setupProperties();
         void calculateAngleOffset();
-        void drawTrianglePointer(QPainter* painter);
+        double getAngleStepsPerRadian();
+        void updateTrianglePointer();
+        NeedleSprite getNeedleSprite();
+
+        static QCache<QByteArray, NeedleSprite>& getNeedleSprites();
 
     protected:
         virtual void renderStatic(QPainter *painter);   // Renders to pixmap_static
         virtual void renderDynamic(QPainter *painter);  // Renders to pixmap
+        virtual QRect prepareDynamic();
+        virtual bool getVisualKey(quint64& key);
+        virtual bool prepareStatic();
 };
 
 #endif // INSTANALOG_H
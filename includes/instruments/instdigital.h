@@ -10,7 +10,8 @@ class InstDigital : public VisuInstrument
         explicit InstDigital(
                 QWidget *parent,
                 QMap<QString, QString> properties,
-                QMap<QString, VisuPropertyMeta> metaProperties) : VisuInstrument(parent, properties, metaProperties)
+                QMap<QString, VisuPropertyMeta> metaProperties) : VisuInstrument(parent, properties, metaProperties),
+                                                                                    mTextVersion(0)
         {
             loadProperties();
         }
@@ -30,10 +31,16 @@ class InstDigital : public VisuInstrument
         // aux members
         QFont mFont;
         QString mFormat;
+        QString mText;          // text of current value
+        quint64 mTextVersion;   // changes whenever text does
+
+        QString formatText();
 
     protected:
         virtual void renderStatic(QPainter *painter);   // Renders to pixmap_static
         virtual void renderDynamic(QPainter *painter);  // Renders to pixmap
+        virtual bool getVisualKey(quint64& key);
+        virtual bool prepareStatic();
 };
 
 #endif // INSTDIGITAL_H
@@ -3,6 +3,8 @@
 
 #include "visuinstrument.h"
 
+class StaticImage;
+
 class InstLED : public VisuInstrument
 {
     Q_OBJECT
@@ -47,10 +49,17 @@ private:
     double mLastValY;
     double mCenterX;
     double mCenterY;
+    bool mConditionOn;
+    StaticImage* mImage;    // image shown for current state, valid during render only
+
+    bool isConditionOn();
 
 protected:
     virtual void renderStatic(QPainter *painter);   // Renders to pixmap_static
     virtual void renderDynamic(QPainter *painter);  // Renders to pixmap
+    virtual QRect prepareDynamic();
+    virtual bool getVisualKey(quint64& key);
+    virtual bool prepareStatic();
 };
 
 
@@ -23,6 +23,9 @@ class InstLinear : public VisuInstrument
         virtual void renderStatic(QPainter *painter);   // Renders to pixmap_static
         virtual void renderDynamic(QPainter *painter);  // Renders to pixmap
         virtual bool refresh(const QString &key);
+        virtual QRect prepareDynamic();
+        virtual bool getVisualKey(quint64& key);
+        virtual bool prepareStatic();
 
     private:
         // configuration properties
@@ -37,10 +40,12 @@ class InstLinear : public VisuInstrument
         // additional properties not related to configuration
         quint16 mBarLength;
         quint16 mMargin;
+        QRect mBar;                 // bar for current value
+        int mBarValue;              // length of bar for current value
 
         void renderDivisions(QPainter* painter);
         void renderLabel(QPainter* painter, int sigCur, quint16 xOfs);
-        void setupMargin(QPainter *painter);
+        void setupMargin();
 
         static const QString KEY_HORIZONTAL;
         static const int SPACING = 5;
@@ -37,6 +37,7 @@ class InstTimePlot : public VisuInstrument
         quint64 cTicksInSecond;
         quint64 cTimespan;           // total time
         quint64 cMarkerDt;           // time between markers
+        bool cScroll;                // scroll graph instead of wiping it at the end
         QColor cColorGraphBackground;
 
         // other properties
@@ -52,12 +53,29 @@ class InstTimePlot : public VisuInstrument
         double  mLastUpdateY;
         double  mNewUpdateX;
         double  mNewUpdateY;
-        QRect   mTimestampRect;
-        QPixmap mGraphPixmap;              // pixmap to contain graph
+        QRect   mTimestampRect;            // area of time label
+        QRect   mGraphDirty;               // area of graph changed in current render
+        VisuLayer mGraphPixmap;            // layer to contain graph
         QPainter* mGraphPainter;
         quint16 mMargin;
         quint16 mMaxLabelWidth;
         double mSigStep;
+        quint64 mLastSequence;             // history sequence number of last plotted sample
+        double  mScrollTime;               // timestamp at the right edge of scrolling graph
+        bool    mRebuildGraph;             // scrolling graph must be redrawn from history
+
+        // Decimation: samples falling into the same pixel column are reduced
+        // to first, min, max and last point, in order of arrival.
+        QVector<QPointF> mGraphPath;       // points waiting to be drawn
+        QVector<QPointF> mGraphSegments;   // point pairs of segments between them
+        int     mColumn;
+        int     mColumnSize;
+        int     mColumnMinOrder;
+        int     mColumnMaxOrder;
+        QPointF mColumnFirst;
+        QPointF mColumnMin;
+        QPointF mColumnMax;
+        QPointF mColumnLast;
 
         static const int PADDING = 5;   //px
 
@@ -71,7 +89,21 @@ class InstTimePlot : public VisuInstrument
         bool shouldRenderMarker(quint64 timestamp);
         void renderTimeLabel(QPainter* painter);
         void renderGraphSegment(QPainter* painter);
+        void renderSample(quint64 timestamp, double value);
+        void addGraphPoint(const QPointF& point);
+        void flushGraphColumn();
+        void appendColumnExtreme(const QPointF& point, int order);
+        void drawGraphPath();
         void resetPlotToStart();
+        void clearGraph(const QRect& rect);
+        void renderSweeping();
+        void renderScrolling();
+        void rebuildGraph(quint64 timestamp);
+        void scrollGraph(quint64 timestamp);
+        void renderScrollSample(quint64 timestamp, double value);
+        void renderScrollMarkers(quint64 from, quint64 to);
+        double getScrollX(quint64 timestamp);
+        QRect getScrollRect();
         bool noSpaceLeftOnRight();
         void init(QPainter* painter);
         void setupGraphObjects();
@@ -79,13 +111,14 @@ class InstTimePlot : public VisuInstrument
         void renderSignalName(QPainter* painter);
         void setupPainter(QPainter* painter);
         double getMarkerX(quint64 timestamp);
-        void calculateNewGraphPoint(quint64 timestamp);
+        void calculateNewGraphPoint(quint64 timestamp, double value);
         void updateLastValues(quint64 timestamp);
 
     protected:
 
         virtual void renderStatic(QPainter *painter);   // Renders to pixmap_static
         virtual void renderDynamic(QPainter *painter);  // Renders to pixmap
+        virtual QRect prepareDynamic();
 
 };
 
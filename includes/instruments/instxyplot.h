@@ -48,14 +48,19 @@ private:
 
     const VisuSignal *mSignalX;
     const VisuSignal *mSignalY;
+    QRect mBall;            // ball for current values
 
     void renderSingleAxis(QPainter* painter, int sigInd, int divisions, int length);
     void renderAxis(QPainter* painter);
     void renderBall(QPainter* painter);
+    void updateBall();
 
 protected:
     virtual void renderStatic(QPainter *painter);   // Renders to pixmap_static
     virtual void renderDynamic(QPainter *painter);  // Renders to pixmap
+    virtual QRect prepareDynamic();
+    virtual bool getVisualKey(quint64& key);
+    virtual bool prepareStatic();
 };
 
 #endif // INSTXYPLOT_H
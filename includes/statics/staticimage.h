@@ -28,6 +28,7 @@ public:
     void paintEvent(QPaintEvent* event);
     virtual bool refresh(const QString& key);
     QImage getImage();
+    void setImage(const QImage& image);
 
 private:
     QImage cImage;
@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QStringList>
+#include <QMap>
 
 class VisuServer;
 
@@ -28,9 +29,13 @@ public:
     static const QString& getCLIArg(CLI_Args arg);
     static void setCLIArgs(int argc, char* argv[]);
     static int argsSize();
+    static bool hasCLIOption(const QString& name);
+    static QString getCLIOption(const QString& name, const QString& defaultValue = QString());
     static void setServer(VisuServer* srv);
     static VisuServer* getServer();
 
+    static const QStringList CLI_FLAGS;
+
 
 private:
     static VisuAppInfo* getInstance();
@@ -40,6 +45,7 @@ private:
     bool configWrong;
     QStringList configIssues;
     QStringList cliArgs;
+    QMap<QString, QString> cliOptions;
     VisuServer* server;
 };
 
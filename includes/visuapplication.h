@@ -7,6 +7,7 @@
 
 #include "visuconfiguration.h"
 #include "visuserver.h"
+#include "visucompiledconfig.h"
 
 
 class VisuApplication : public QWidget
@@ -14,7 +15,9 @@ class VisuApplication : public QWidget
     private:
         VisuConfiguration* mConfiguration;
         VisuServer *mServer;
+        VisuCompiledConfig mCompiledConfig;
         void setupWindow();
+        void setupTracing();
         void loadConfiguration(QString path);
 
     public:
@@ -0,0 +1,71 @@
+#ifndef VISUBULKUDPSOCKET_H
+#define VISUBULKUDPSOCKET_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QSocketNotifier>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+/**
+ * @brief The VisuBulkUdpSocket class
+ * Native UDP receive path, which drains up to batch size datagrams per
+ * recvmmsg call into preallocated slab, along with IPv4 sender
+ * addresses. Number of datagrams dropped by the kernel because socket
+ * buffer was full is reported through SO_RXQ_OVFL.
+ *
+ * Available on Linux only, see isSupported().
+ */
+class VisuBulkUdpSocket : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VisuBulkUdpSocket(int batchSize, QObject* parent = nullptr);
+    virtual ~VisuBulkUdpSocket();
+
+    static bool isSupported();
+
+    bool bind(const QHostAddress& address, quint16 port, int receiveBufferSize);
+    void close();
+    int receive();
+
+    const quint8* datagramData(int index) const;
+    qint64 datagramSize(int index) const;
+    bool isTruncated(int index) const;
+    quint64 datagramSource(int index) const;
+    int getBatchSize() const;
+    int getReceiveBufferSize() const;
+    quint64 getKernelDrops() const;
+
+    static const int MAX_DATAGRAM_SIZE = 65536;
+
+signals:
+    void readyRead();
+
+private:
+    int mFd;
+    int mBatchSize;
+    QSocketNotifier* mNotifier;
+
+    // slab is left uninitialized, so pages of slots never written by
+    // kernel are not committed
+    std::unique_ptr<quint8[]> mSlab;
+
+#ifdef Q_OS_LINUX
+    QVector<mmsghdr> mMessages;
+    QVector<iovec> mVectors;
+    QVector<sockaddr_in> mAddresses;
+    QVector<char> mControl;
+#endif
+
+    std::atomic<quint64> mKernelDrops;
+};
+
+#endif // VISUBULKUDPSOCKET_H
@@ -0,0 +1,101 @@
+#ifndef VISUCOMPILEDCONFIG_H
+#define VISUCOMPILEDCONFIG_H
+
+#include <QFile>
+#include <QImage>
+#include <QMap>
+#include <QString>
+#include "visuconfiguration.h"
+
+/**
+ * Binary form of configuration, produced from XML by "--compile" and
+ * loaded without XML parsing. File consists of header, string table with
+ * deduplicated UTF-16 strings, element and property tables referencing
+ * strings by index, and raw ARGB32 premultiplied pixels of static images.
+ * All numbers are in host byte order, so file is meant to be compiled on
+ * machine it runs on. XML remains the editable source.
+ */
+class VisuCompiledConfig
+{
+public:
+    VisuCompiledConfig();
+    ~VisuCompiledConfig();
+
+    static bool isCompiled(const QString& path);
+    static void compile(const QString& xmlPath, const QString& outputPath);
+
+    void open(const QString& path);
+    VisuConfiguration::Elements getElements() const;
+    QMap<int, QImage> getImages() const;
+
+    static const quint32 MAGIC = 0x47464356;   // "VCFG"
+    static const quint32 BYTE_ORDER_MARK = 0x01020304;
+    static const quint16 VERSION = 1;
+
+private:
+    struct Header
+    {
+        quint32 magic;
+        quint32 byteOrder;
+        quint16 version;
+        quint16 reserved;
+        quint32 stringCount;
+        quint32 elementCount;
+        quint32 propertyCount;
+        quint32 imageCount;
+        quint32 stringsOffset;
+        quint32 poolOffset;
+        quint32 poolSize;
+        quint32 elementsOffset;
+        quint32 propertiesOffset;
+        quint32 imagesOffset;
+    };
+
+    struct StringEntry
+    {
+        quint32 offset;     // in characters, from start of pool
+        quint32 length;
+    };
+
+    enum ElementKind : quint32
+    {
+        ELEMENT_CONFIGURATION,
+        ELEMENT_SIGNAL,
+        ELEMENT_WIDGET
+    };
+
+    struct ElementEntry
+    {
+        quint32 kind;
+        quint32 firstProperty;
+        quint32 propertyCount;
+    };
+
+    struct PropertyEntry
+    {
+        quint32 key;
+        quint32 value;
+    };
+
+    struct ImageEntry
+    {
+        quint32 widget;     // index among widget elements
+        quint32 width;
+        quint32 height;
+        quint32 bytesPerLine;
+        quint32 offset;     // from start of file
+        quint32 size;
+    };
+
+    static const int IMAGE_ALIGNMENT = 16;
+
+    template <typename T>
+    const T* table(quint32 offset, quint32 count) const;
+
+    QFile mFile;
+    const uchar* mData;
+    qint64 mSize;
+    const Header* mHeader;
+};
+
+#endif // VISUCOMPILEDCONFIG_H
@@ -17,7 +17,30 @@ public:
     static QMap<QString, QString> getMapFromFile(QString type, QString tag);
     static QMap<QString, VisuPropertyMeta> getMetaMapFromFile(QString type, QString tag);
 
+    // Process-wide meta registry
+    static const QMap<QString, VisuPropertyMeta>& getMetaMap(const QString& type, const QString& tag);
+    static bool loadMetaCache(const QString& path);
+    static void saveMetaCache(const QString& path);
+
     static const QString PATH;
+    static const QString META_CACHE_PATH;
+
+private:
+    struct MetaEntry
+    {
+        QMap<QString, VisuPropertyMeta> meta;
+        qint64 sourceSize;
+        qint64 sourceModified;      // ms since epoch
+    };
+
+    // QMap, so references returned by getMetaMap stay valid on insert
+    static QMap<QString, MetaEntry> metaRegistry;
+    static bool metaRegistryChanged;
+
+    static const quint32 META_CACHE_MAGIC = 0x564D4554;    // "VMET"
+    static const quint16 META_CACHE_VERSION = 2;
+
+    static QString getSourcePath(const QString& type);
 };
 
 #endif // VISUCONFIGLOADER_H
@@ -6,38 +6,82 @@
 #include "ctrlbutton.h"
 #include "statics/staticimage.h"
 #include "visupropertymeta.h"
+#include "visuproperties.h"
 #include "visuconfigloader.h"
+#include "visusignaldispatch.h"
 #include <QWidget>
 #include <QObject>
 #include <QXmlStreamReader>
 #include <QPointer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSharedPointer>
 #include <vector>
 
+class VisuCompiledConfig;
+
 class VisuConfiguration : public QObject
 {
     Q_OBJECT
 
+    public:
+
+        typedef enum
+        {
+            PHASE_TOKENIZE,
+            PHASE_META,
+            PHASE_CONSTRUCT,
+            PHASE_WIRING,
+            PHASE_RENDER,
+            PHASE_COUNT
+        } LoadPhase;
+
+        // Duration and process peak memory at the end of each phase of
+        // the last fromXML or fromCompiled call
+        struct LoadProfile
+        {
+            qint64 elapsedNs[PHASE_COUNT];
+            qint64 peakMemoryKb[PHASE_COUNT];
+        };
+
+        // Properties of configuration elements, as read from the document
+        struct Elements
+        {
+            QMap<QString, QString> configurationProperties;
+            QVector<QMap<QString, QString>> signalsProperties;
+            QVector<QMap<QString, QString>> widgetsProperties;
+        };
+
     private:
 
         static VisuConfiguration* instance;
         QVector<QPointer<VisuSignal>> signalsList;
         QVector<QPointer<VisuWidget>> widgetsList;
+        QSharedPointer<const VisuSignalDispatch> mSignalDispatch;
+        mutable QMutex mSignalDispatchMutex;
 
         template <typename T>
         static void append(T* elem, QString& xml, int tabs);
-        void createSignalFromToken(QXmlStreamReader& xml_reader);
-        void createConfigurationFromToken(QXmlStreamReader& xmlReader);
+        void createSignal(const QMap<QString, QString>& properties);
+        void createConfiguration(const QMap<QString, QString>& properties);
         int getFreeId(QVector<QPointer<QObject> > &list);
+        void finishPhase(LoadPhase phase, QElapsedTimer& timer);
+        void fromElements(QWidget *parent, const Elements& elements, QElapsedTimer& timer);
+
+        LoadProfile mLoadProfile;
 
         // Properties
         quint16 cPort;
         quint16 cWidth;
         quint16 cHeight;
         QColor cColorBackground;
+        quint16 cRenderFps;
+        bool cRasterLayers;
         QString cName;
         quint8 cConectivity;
         QString cSerialPort;
         quint32 cBaudRate;
+        quint8 cSerialProtocol;
         bool cSerialBindToSignal;
         QString cSerialRegex;
         bool cSerialStartEnable;
@@ -45,14 +89,20 @@ class VisuConfiguration : public QObject
         bool cPullMessageEnable;
         QString cPullMessage;
         quint32 cPullPeriod;
+        bool cUdpBulkReceive;
+        quint16 cUdpBatchSize;
+        quint32 cUdpReceiveBuffer;
+        bool cDropStaleSamples;
 
-        QMap<QString, QString> mProperties;
+        VisuProperties mProperties;
         QMap<QString, VisuPropertyMeta> mPropertiesMeta;
 
-        VisuConfiguration()
+        VisuConfiguration() : mSignalDispatch(new VisuSignalDispatch()),
+                              mLoadProfile()
         {
-            mPropertiesMeta = VisuConfigLoader::getMetaMapFromFile(VisuConfiguration::TAG_NAME,
-                                                                   VisuConfiguration::TAG_NAME);
+            mPropertiesMeta = VisuConfigLoader::getMetaMap(VisuConfiguration::TAG_NAME,
+                                                           VisuConfiguration::TAG_NAME);
+            mProperties.setSchema(VisuPropertySchema::compile(VisuConfiguration::TAG_NAME, mPropertiesMeta));
         }
 
     public:
@@ -61,15 +111,18 @@ class VisuConfiguration : public QObject
         static VisuConfiguration* getClean();
         virtual ~VisuConfiguration();
         void setConfigValues();
+        static Elements parseXML(const QString& xml);
         void fromXML(QWidget *parent, const QString& xml);
+        void fromCompiled(QWidget *parent, const VisuCompiledConfig& compiled);
         QString toXML();
+        const LoadProfile& getLoadProfile() const;
         void initializeInstruments();
         void updateProperties(const QString& key, const QString& value);
         void setPropertiesMeta(QMap<QString, VisuPropertyMeta> meta);
         QMap<QString, VisuPropertyMeta> getPropertiesMeta();
 
         // General widget methods
-        QPointer<VisuWidget> createWidgetFromToken(QXmlStreamReader& xmlReader, QWidget *parent);
+        QPointer<VisuWidget> createWidget(const QMap<QString, QString>& properties, QWidget *parent);
         void addWidget(QPointer<VisuWidget> widget);
         void deleteWidget(QPointer<VisuWidget> widget);
         QVector<QPointer<VisuWidget>> getWidgets();
@@ -103,16 +156,21 @@ class VisuConfiguration : public QObject
         void deleteSignal(int signalId);
         QPointer<VisuSignal> getSignal(quint16 signalId);
         QVector<QPointer<VisuSignal>> &getSignals();
+        QSharedPointer<const VisuSignalDispatch> getSignalDispatch() const;
+        void rebuildSignalDispatch();
 
         // Getters
-        QMap<QString, QString>& getProperties();
+        const QMap<QString, QString>& getProperties() const;
         quint16 getPort();
         QString getSerialPort();
         quint32 getBaudRate();
+        quint8 getSerialProtocol();
         quint16 getWidth();
         quint16 getHeight();
         QSize getSize() const;
         QColor getBackgroundColor();
+        quint16 getRenderFps();
+        bool isRasterLayers();
         QString getName();
         quint8 getConectivity();
         bool isSerialBindToSignal();
@@ -122,6 +180,10 @@ class VisuConfiguration : public QObject
         bool isSerialPullEnabled();
         QString getSerialPullString();
         quint32 getSerialPullPeriod();
+        bool isUdpBulkReceive();
+        quint16 getUdpBatchSize();
+        quint32 getUdpReceiveBuffer();
+        bool isDropStaleSamples();
 
         static const QString TAG_WIDGET;
         static const QString TAG_SIGNAL;
@@ -11,6 +11,10 @@ struct VisuDatagram
     quint16 packetNumber;
     quint8 checksum;
 
+    // trace clock times, set only while latency tracing is enabled
+    quint64 traceReceived;
+    quint64 traceDecoded;
+
     bool checksumOk();
 };
 
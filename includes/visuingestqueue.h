@@ -0,0 +1,47 @@
+#ifndef VISUINGESTQUEUE_H
+#define VISUINGESTQUEUE_H
+
+#include <QObject>
+#include <atomic>
+#include "visudatagram.h"
+#include "visuringbuffer.h"
+
+/**
+ * @brief The VisuIngestQueue class
+ * Hands decoded datagrams over from the ingest thread to the GUI thread.
+ * Object lives in the GUI thread, push() and countDrop() are called from
+ * the ingest thread, while drain() runs in the GUI event loop.
+ */
+class VisuIngestQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VisuIngestQueue(int capacity = DEFAULT_CAPACITY);
+
+    void push(const VisuDatagram& datagram);
+    void push(const VisuDatagram* datagrams, int count);
+    void countDrop();
+
+    quint64 getOverruns() const;
+    quint64 getDrops() const;
+    quint64 getDelivered() const;
+    int getFree() const;
+
+    static const int DEFAULT_CAPACITY = 4096;
+
+public slots:
+    void drain();
+
+private:
+    VisuRingBuffer<VisuDatagram> mBuffer;
+    std::atomic<bool> mDrainPending;
+
+    std::atomic<quint64> mOverruns;     // datagrams lost because buffer was full
+    std::atomic<quint64> mDrops;        // malformed datagrams or unknown signals
+    std::atomic<quint64> mDelivered;    // datagrams passed on to signals
+
+    void scheduleDrain();
+};
+
+#endif // VISUINGESTQUEUE_H
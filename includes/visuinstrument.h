@@ -4,11 +4,11 @@
 #include <QtGlobal>
 #include <QWidget>
 #include <QColor>
-#include <QPixmap>
 #include <QMap>
 #include <QPainter>
 #include <QPointer>
 
+#include "visulayer.h"
 #include "visupropertyloader.h"
 #include "visusignal.h"
 #include "visuwidget.h"
@@ -29,16 +29,31 @@ protected:
     quint8 cFontSize;           // Size of font used on labels
     QString cFontType;
 
-    // pixmaps
-    QPixmap mPixmap;        // holds instrument rendered with last received signal value
-    QPixmap mPixmapStatic;  // holds prerendered pixmap generated by renderStatic()
+    // layers
+    VisuLayer mPixmap;        // holds instrument rendered with last received signal value
+    VisuLayer mPixmapStatic;  // holds prerendered layer generated by renderStatic()
+    QRect   mDynamicRect;   // area covered by dynamic parts in last render
+    quint64 mVisualKey;     // visual key of last render
+    bool    mVisualKeyValid;
 
     bool    mFirstRun;
+    bool    mRenderPending;     // true while waiting for next frame of render scheduler
     const VisuSignal *mSignal; // Pointer to last signal that was updated
 
+    VisuTraceSample mTrace;     // latency stamps of last rendered value
+    bool    mTracePending;      // rendered value is traced, but not yet painted
+
     void paintEvent(QPaintEvent* event);
     virtual void renderStatic(QPainter*) = 0;   // Renders static parts of instrument
     virtual void renderDynamic(QPainter*) = 0;  // Renders signal value dependent parts
+    virtual QRect prepareDynamic();             // Updates dynamic state, returns area it covers
+    virtual bool getVisualKey(quint64& key);    // Quantized state that affects pixels
+    virtual bool prepareStatic();               // Updates layout state, returns true if static layer is shareable
+
+    void renderStaticLayer();
+    QByteArray getStaticKey();
+    QFont getFont();
+    VisuLayer createLayer(int width, int height);
 
     void setFont(QPainter* painter);
     void setPen(QPainter* painter, QColor color, int thickness = 1);
@@ -60,7 +75,8 @@ public:
     explicit VisuInstrument(QWidget *parent,
                             QMap<QString, QString> properties,
                             QMap<QString, VisuPropertyMeta> metaProperties)
-        : VisuWidget(parent, properties, metaProperties) {}
+        : VisuWidget(parent, properties, metaProperties), mVisualKey(0), mVisualKeyValid(false), mRenderPending(false),
+          mTrace(), mTracePending(false) {}
 
     virtual bool updateProperties(const QString &key, const QString &value);
     void loadProperties();
@@ -71,7 +87,9 @@ public:
     // Getters
     quint16 getSignalId();
     quint16 getId();
-    void render();
+    bool render();
+    bool isRenderPending() const;
+    void setRenderPending(bool pending);
 };
 
 #endif // INSTRUMENT_H
@@ -0,0 +1,28 @@
+#ifndef VISULATENCYOVERLAY_H
+#define VISULATENCYOVERLAY_H
+
+#include <QLabel>
+#include <QTimer>
+
+/**
+ * @brief The VisuLatencyOverlay class
+ * Shows latency summary of VisuLatencyTracer on top of the dashboard,
+ * refreshed periodically. Does not take mouse input.
+ */
+class VisuLatencyOverlay : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit VisuLatencyOverlay(QWidget* parent);
+
+    static const int REFRESH_PERIOD = 500;  // ms
+
+private slots:
+    void refresh();
+
+private:
+    QTimer mTimer;
+};
+
+#endif // VISULATENCYOVERLAY_H
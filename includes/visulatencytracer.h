@@ -0,0 +1,115 @@
+#ifndef VISULATENCYTRACER_H
+#define VISULATENCYTRACER_H
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The VisuTraceSample struct
+ * Trace clock times, in ns, at which one sample passed each point on its
+ * way from socket to screen.
+ */
+struct VisuTraceSample
+{
+    quint64 received;       // read from socket or serial port
+    quint64 decoded;        // passed to ingest queue
+    quint64 updated;        // VisuSignal::datagramUpdate
+    quint64 renderStart;    // VisuInstrument::render
+    quint64 renderEnd;
+    quint64 painted;        // VisuInstrument::paintEvent
+    quint16 signalId;
+
+    enum Stage
+    {
+        STAGE_DECODE,       // received -> decoded
+        STAGE_QUEUE,        // decoded -> updated
+        STAGE_SCHEDULE,     // updated -> renderStart
+        STAGE_RENDER,       // renderStart -> renderEnd
+        STAGE_PAINT,        // renderEnd -> painted
+        STAGE_COUNT
+    };
+};
+
+/**
+ * @brief The VisuLatencyHistogram class
+ * Log-linear histogram of durations in ns. Every power of two is split
+ * into 16 buckets, so percentiles are within about 6% of exact value.
+ */
+class VisuLatencyHistogram
+{
+public:
+    VisuLatencyHistogram();
+
+    void add(quint64 value);
+    quint64 getCount() const;
+    quint64 getMax() const;
+    quint64 getPercentile(double percentile) const;
+
+private:
+    static const int SUB_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    static int bucketOf(quint64 value);
+    static quint64 upperBoundOf(int bucket);
+
+    QVector<quint64> mBuckets;
+    quint64 mCount;
+    quint64 mMax;
+};
+
+/**
+ * @brief The VisuLatencyTracer class
+ * Optional tracing of sample latency, from packet arrival to pixels.
+ * Ingest thread stamps datagrams, signals and instruments carry stamps
+ * along, and paintEvent hands complete sample over to the tracer, which
+ * aggregates it into per-instrument and per-stage histograms and keeps
+ * the most recent samples for Chrome trace-event export.
+ *
+ * Tracing is disabled by default, in which case every trace point costs
+ * a single branch. All methods except now() are called from GUI thread.
+ */
+class VisuLatencyTracer
+{
+public:
+    static VisuLatencyTracer* get();
+
+    static inline bool isEnabled()
+    {
+        return enabled;
+    }
+    static quint64 now();
+
+    void enable();
+    void record(quint16 instrumentId, const VisuTraceSample& sample);
+    QString getSummary() const;
+    bool writeChromeTrace(const QString& path) const;
+
+    static const int MAX_SAMPLES = 20000;  // kept for trace export
+
+private:
+    VisuLatencyTracer();
+
+    static VisuLatencyTracer* instance;
+    static bool enabled;
+    static QElapsedTimer clock;
+
+    struct Recorded
+    {
+        quint16 instrumentId;
+        VisuTraceSample sample;
+    };
+
+    QMap<quint16, VisuLatencyHistogram> mInstruments;  // received -> painted
+    VisuLatencyHistogram mStages[VisuTraceSample::STAGE_COUNT];
+    QVector<Recorded> mSamples;
+    int mNextSample;
+
+    static QString formatDuration(quint64 ns);
+    static QString formatHistogram(const VisuLatencyHistogram& histogram);
+};
+
+#endif // VISULATENCYTRACER_H
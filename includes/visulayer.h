@@ -0,0 +1,43 @@
+#ifndef VISULAYER_H
+#define VISULAYER_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QPainter>
+
+/**
+ * @brief The VisuLayer class
+ * Offscreen buffer instruments render to. Either a QPixmap, stored as
+ * platform prefers, or, with raster layers enabled, a QImage in
+ * Format_ARGB32_Premultiplied drawn by the raster paint engine. Image is
+ * only converted for screen when it is composited, and unlike pixmap it
+ * may be painted on threads other than GUI thread.
+ *
+ * Layer data is implicitly shared, like the buffer it wraps.
+ */
+class VisuLayer
+{
+public:
+    VisuLayer();
+    VisuLayer(int width, int height, bool raster);
+
+    QPaintDevice* device();
+    bool isRaster() const;
+    bool isNull() const;
+    bool isDetached() const;
+    QRect rect() const;
+    QSize size() const;
+    int byteCount() const;
+
+    void fill(const QColor& color);
+    void scroll(int dx, int dy, const QRect& rect);
+    void draw(QPainter* painter, const QRect& target, const QRect& source) const;
+    void draw(QPainter* painter, const QPoint& position) const;
+
+private:
+    bool mRaster;
+    QPixmap mPixmap;
+    QImage mImage;
+};
+
+#endif // VISULAYER_H
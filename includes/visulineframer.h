@@ -0,0 +1,46 @@
+#ifndef VISULINEFRAMER_H
+#define VISULINEFRAMER_H
+
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * @brief The VisuLineFramer class
+ * Splits byte stream into delimited lines. Bytes are read straight into
+ * ring buffer (see getWriteBuffer), and lines are returned as pointers
+ * into it, so nothing is copied or allocated per line. Only a line that
+ * wraps around the end of the ring is copied, into preallocated scratch
+ * buffer.
+ *
+ * Line that does not fit the ring is discarded, and framing continues
+ * from the next delimiter.
+ */
+class VisuLineFramer
+{
+public:
+    explicit VisuLineFramer(int capacity = DEFAULT_CAPACITY, char delimiter = '\n');
+
+    char* getWriteBuffer(int& size);
+    void commit(int size);
+    bool nextLine(const char*& line, int& length);
+    void clear();
+    void setDelimiter(char delimiter);
+    quint64 getOverflows() const;
+
+    static const int DEFAULT_CAPACITY = 4096;
+
+private:
+    std::vector<char> mBuffer;
+    std::vector<char> mScratch;
+    size_t mMask;
+    size_t mHead;       // write position
+    size_t mTail;       // start of current line
+    size_t mScan;       // position up to which delimiter was searched for
+    char mDelimiter;
+    bool mDiscarding;   // skipping rest of too long line
+    quint64 mOverflows;
+
+    static size_t roundUp(int capacity);
+};
+
+#endif // VISULINEFRAMER_H
@@ -0,0 +1,33 @@
+#ifndef VISUMETRICS_H
+#define VISUMETRICS_H
+
+#include <QtGlobal>
+#include <QMap>
+#include "visusequencetracker.h"
+
+/**
+ * Snapshot of counters along the path of a sample, from socket to screen,
+ * used to tell where data is lost or delayed. See VisuServer::getMetrics().
+ */
+struct VisuMetrics
+{
+    // network
+    quint64 kernelDrops;        // socket buffer overflows, bulk receive only
+    QMap<quint16, VisuSequenceStats> sources;          // single datagrams, by signal
+    QMap<quint64, VisuSequenceStats> frameSources;     // batched frames, by sender
+
+    // ingest thread
+    quint64 malformed;          // bad checksum, size or unknown signal
+    quint64 staleDropped;
+    quint64 overruns;           // ingest queue was full
+    quint64 delivered;
+
+    // rendering
+    quint64 framesRendered;
+    quint64 instrumentsRendered;
+    quint64 updatesCoalesced;
+    quint64 rendersSkipped;     // visual key did not change
+    quint64 staticLayersShared; // taken from identical instrument instead of rendered
+};
+
+#endif // VISUMETRICS_H
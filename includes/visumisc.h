@@ -24,6 +24,7 @@ public:
     static QColor strToColor(const QString& str);
     static QString colorToStr(const QColor& color);
     static QImage strToImage(const QString& str, const QString &format);
+    static qint64 getPeakMemoryKb();
 };
 
 #endif // VISUMISC_H
@@ -0,0 +1,56 @@
+#ifndef VISUPROPERTIES_H
+#define VISUPROPERTIES_H
+
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QSharedPointer>
+#include "visupropertymeta.h"
+#include "visupropertyschema.h"
+
+/**
+ * @brief The VisuProperties class
+ * Property values of one element. Values are kept in a string map, which
+ * is what editor and XML export work with, and in slots of the compiled
+ * schema of element type. Every slot remembers whether it changed since it
+ * was last taken by VisuPropertyLoader, so reloading properties after an
+ * edit parses only the changed ones.
+ *
+ * Values must be modified through set(), which keeps both views in sync.
+ */
+class VisuProperties
+{
+public:
+    VisuProperties();
+    VisuProperties(const QMap<QString, QString>& properties);
+    VisuProperties& operator=(const QMap<QString, QString>& properties);
+
+    void setSchema(QSharedPointer<const VisuPropertySchema> schema);
+
+    const QMap<QString, QString>& map() const;
+    bool contains(const QString& key) const;
+    QString value(const QString& key) const;
+    void set(const QString& key, const QString& value);
+    void swap(const QString& first, const QString& second);
+
+    // Slot access used by VisuPropertyLoader
+    bool contains(int keyId) const;
+    const VisuPropertyMeta& meta(int keyId) const;
+    const QString* take(int keyId);
+
+private:
+    struct Slot
+    {
+        QString value;
+        bool present;
+        bool changed;
+    };
+
+    QMap<QString, QString> mMap;
+    QSharedPointer<const VisuPropertySchema> mSchema;
+    QVector<Slot> mSlots;
+
+    void assignSlots();
+};
+
+#endif // VISUPROPERTIES_H
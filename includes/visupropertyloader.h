@@ -4,60 +4,38 @@
 #include <QColor>
 #include <QImage>
 #include "visupropertymeta.h"
+#include "visuproperties.h"
 
-#define GET_PROPERTY(KEY, MAP, METAMAP) \
-    VisuPropertyLoader::set( KEY, \
-                             VisuPropertyLoader::transformKey(#KEY),\
-                             MAP, \
-                             METAMAP)
+// Key id is resolved once per call site, loading itself is done
+// without string operations.
+#define GET_PROPERTY(KEY, PROPERTIES) \
+    do { \
+        static const int keyId = VisuPropertySchema::keyId(VisuPropertyLoader::transformKey(#KEY)); \
+        VisuPropertyLoader::set(KEY, keyId, PROPERTIES); \
+    } while (0)
 
 namespace VisuPropertyLoader
 {
     QString transformKey(const QString& key);
-    void checkIfKeyExists(QString key, QMap<QString, QString> properties);
-    void handleMissingKey(const QString& key,
-                          QMap<QString, QString>& properties,
-                          const QMap<QString, VisuPropertyMeta>& metaProperties);
+    const QString* take(int keyId, VisuProperties& properties);
 
     // handles all integer numeric types
     template <typename T>
-    void set(  T& property,
-          const QString& key,
-          QMap<QString, QString>& properties,
-          const QMap<QString, VisuPropertyMeta>& metaProperties)
+    void set(T& property, int keyId, VisuProperties& properties)
     {
-        handleMissingKey(key, properties, metaProperties);
-        property = (T)properties[key].toLongLong();
+        const QString* value = take(keyId, properties);
+        if (value != nullptr)
+        {
+            property = (T)value->toLongLong();
+        }
     }
 
     // specializations below
-    void set( double& property,
-              const QString& key,
-              QMap<QString, QString>& properties,
-              const QMap<QString, VisuPropertyMeta>& metaProperties);
-
-    void set( QString& property,
-              const QString& key,
-              QMap<QString, QString>& properties,
-              const QMap<QString, VisuPropertyMeta>& metaProperties);
-
-
-    void set( QColor& property,
-              const QString& key,
-              QMap<QString, QString>& properties,
-              const QMap<QString, VisuPropertyMeta>& metaProperties);
-
-
-    void set( QImage& property,
-              const QString& key,
-              QMap<QString, QString>& properties,
-              const QMap<QString, VisuPropertyMeta>& metaProperties);
-
-
-    void set( bool& property,
-              const QString& key,
-              QMap<QString, QString>& properties,
-              const QMap<QString, VisuPropertyMeta>& metaProperties);
+    void set(double& property, int keyId, VisuProperties& properties);
+    void set(QString& property, int keyId, VisuProperties& properties);
+    void set(QColor& property, int keyId, VisuProperties& properties);
+    void set(QImage& property, int keyId, VisuProperties& properties);
+    void set(bool& property, int keyId, VisuProperties& properties);
 }
 
 
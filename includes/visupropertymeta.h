@@ -4,6 +4,7 @@
 #include <QString>
 #include <QStringList>
 #include <QMap>
+#include <QDataStream>
 
 class VisuPropertyMeta
 {
@@ -13,7 +14,8 @@ public:
                             max(std::numeric_limits<int>::max()),
                             defaultVal(""),
                             type(DEFAULT),
-                            extra("") {}
+                            extra(""),
+                            optional(false) {}
 
     typedef enum
     {
@@ -45,6 +47,7 @@ public:
     int order;
     QString depends;
     QString description;
+    bool optional;      // missing in configurations written before property existed, default is used
 
     QStringList getEnumOptions();
     bool isEnabled(const QMap<QString, QString>& properties) const;
@@ -60,6 +63,10 @@ public:
     static const QString KEY_LABEL;
     static const QString KEY_DEPENDS;
     static const QString KEY_DEPSCRIPTION;
+    static const QString KEY_OPTIONAL;
 };
 
+QDataStream& operator<<(QDataStream& stream, const VisuPropertyMeta& meta);
+QDataStream& operator>>(QDataStream& stream, VisuPropertyMeta& meta);
+
 #endif // VISUPROPERTYMETA_H
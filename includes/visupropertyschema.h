@@ -0,0 +1,46 @@
+#ifndef VISUPROPERTYSCHEMA_H
+#define VISUPROPERTYSCHEMA_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QSharedPointer>
+#include "visupropertymeta.h"
+
+/**
+ * @brief The VisuPropertySchema class
+ * Property meta of one element type (widget type, signal or configuration)
+ * compiled to indexed form. Every property key gets process-wide integer
+ * id, and schema maps key ids to dense slots of the type, so property
+ * storage can be addressed without string lookups.
+ *
+ * Schemas are compiled once per type and shared between all instances.
+ */
+class VisuPropertySchema
+{
+public:
+    static int keyId(const QString& key);
+    static const QString& keyName(int keyId);
+    static QSharedPointer<const VisuPropertySchema> compile(const QString& type,
+                                                            const QMap<QString, VisuPropertyMeta>& meta);
+
+    int size() const;
+    int slot(int keyId) const;                  // -1 if type has no such property
+    int slot(const QString& key) const;
+    const QString& key(int slot) const;
+    const VisuPropertyMeta& meta(int slot) const;
+
+private:
+    explicit VisuPropertySchema(const QMap<QString, VisuPropertyMeta>& meta);
+
+    QVector<int> mSlots;                        // indexed by key id
+    QVector<QString> mKeys;                     // indexed by slot
+    QVector<VisuPropertyMeta> mMeta;            // indexed by slot
+
+    static QHash<QString, int> keyIds;
+    static QVector<QString> keyNames;
+    static QHash<QString, QSharedPointer<const VisuPropertySchema>> schemas;
+};
+
+#endif // VISUPROPERTYSCHEMA_H
@@ -0,0 +1,54 @@
+#ifndef VISURENDERSCHEDULER_H
+#define VISURENDERSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <QPointer>
+
+class VisuInstrument;
+
+/**
+ * @brief The VisuRenderScheduler class
+ * Coalesces instrument updates. Signal updates only mark instruments as
+ * dirty, while frame timer renders every dirty instrument once per frame
+ * using the latest signal value. Timer stops when there is nothing to
+ * render, so an idle dashboard does not wake up the event loop.
+ */
+class VisuRenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static VisuRenderScheduler* get();
+
+    void schedule(VisuInstrument* instrument);
+
+    quint64 getFramesRendered() const;
+    quint64 getInstrumentsRendered() const;
+    quint64 getUpdatesCoalesced() const;
+    quint64 getRendersSkipped() const;
+
+private slots:
+    void renderFrame();
+
+private:
+    VisuRenderScheduler();
+
+    static VisuRenderScheduler* instance;
+
+    QTimer mTimer;
+    QVector<QPointer<VisuInstrument>> mDirty;
+    QVector<QPointer<VisuInstrument>> mRendering;
+
+    quint64 mFramesRendered;
+    quint64 mInstrumentsRendered;
+    quint64 mUpdatesCoalesced;
+    quint64 mRendersSkipped;
+
+    void countRender(bool rendered);
+
+    static const int MS_IN_SECOND = 1000;
+};
+
+#endif // VISURENDERSCHEDULER_H
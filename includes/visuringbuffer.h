@@ -0,0 +1,89 @@
+#ifndef VISURINGBUFFER_H
+#define VISURINGBUFFER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief The VisuRingBuffer class
+ * Bounded, lock-free ring buffer for exactly one producer thread and
+ * exactly one consumer thread. Capacity is rounded up to power of two,
+ * so indices can be wrapped with a mask.
+ */
+template <typename T>
+class VisuRingBuffer
+{
+public:
+    explicit VisuRingBuffer(int capacity) :   mItems(roundUp(capacity)),
+                                              mMask(mItems.size() - 1),
+                                              mHead(0),
+                                              mTail(0) {}
+
+    // Producer side. Returns false if buffer is full.
+    bool push(const T& item)
+    {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) > mMask)
+        {
+            return false;
+        }
+
+        mItems[head & mMask] = item;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if buffer is empty.
+    bool pop(T& item)
+    {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail == mHead.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = mItems[tail & mMask];
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return mTail.load(std::memory_order_acquire) == mHead.load(std::memory_order_acquire);
+    }
+
+    int size() const
+    {
+        return (int)(mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire));
+    }
+
+    int capacity() const
+    {
+        return (int)mItems.size();
+    }
+
+private:
+    static size_t roundUp(int capacity)
+    {
+        size_t size = 1;
+        while (size < (size_t)capacity)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static const int CACHE_LINE = 64;
+
+    std::vector<T> mItems;
+    const size_t mMask;
+
+    // head and tail are written by different threads, keep them on separate cache lines
+    char mPaddingHead[CACHE_LINE];
+    std::atomic<size_t> mHead;
+    char mPaddingTail[CACHE_LINE];
+    std::atomic<size_t> mTail;
+};
+
+#endif // VISURINGBUFFER_H
@@ -0,0 +1,72 @@
+#ifndef VISUSEQUENCETRACKER_H
+#define VISUSEQUENCETRACKER_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+
+struct VisuSequenceStats
+{
+    quint64 received;       // samples seen, including dropped ones
+    quint64 gaps;           // packet numbers skipped over
+    quint64 duplicates;     // packet number seen again
+    quint64 reordered;      // packet number older than the last one
+    quint64 resets;         // sender restarted its numbering
+    quint64 staleDropped;   // duplicates and reordered samples not delivered
+    quint16 lastPacketNumber;
+
+    // gaps later filled by reordered packets are not lost
+    quint64 getLost() const
+    {
+        return gaps > reordered ? gaps - reordered : 0;
+    }
+};
+
+/**
+ * @brief The VisuSequenceTracker class
+ * Follows packet numbers to detect lost, duplicated and reordered
+ * packets. Numbers are 16 bit and compared with wrap around.
+ *
+ * Single datagrams are numbered per signal, so they are followed per
+ * signal. Batched frames carry one packet number for the whole frame,
+ * and signals need not be present in every frame, so frames are
+ * followed per source, meaning sender address or serial port. For frame
+ * sources, received counts frames, while staleDropped counts samples.
+ *
+ * accept() and acceptFrame() are called from the ingest thread without
+ * locking. Ingest thread publishes statistics every PUBLISH_INTERVAL_MS,
+ * and getStats() returns last published snapshot.
+ */
+class VisuSequenceTracker
+{
+public:
+    VisuSequenceTracker();
+
+    void setDropStale(bool dropStale);
+    bool accept(quint16 signalId, quint16 packetNumber);
+    bool acceptFrame(quint64 source, quint16 packetNumber, int samples);
+    void publish();
+
+    QMap<quint16, VisuSequenceStats> getStats() const;
+    QMap<quint64, VisuSequenceStats> getFrameStats() const;
+
+    // older numbers are taken as sender restart, not reordering
+    static const int MAX_REORDER = 256;
+    static const int PUBLISH_INTERVAL_MS = 100;
+    static const quint64 SERIAL_SOURCE = 0;
+
+private:
+    QHash<quint16, VisuSequenceStats> mSignals;
+    QHash<quint64, VisuSequenceStats> mFrames;
+    bool mDropStale;
+    bool mChanged;
+
+    mutable QMutex mMutex;      // guards snapshots only
+    QMap<quint16, VisuSequenceStats> mSignalsSnapshot;
+    QMap<quint64, VisuSequenceStats> mFramesSnapshot;
+
+    bool update(VisuSequenceStats& stats, quint16 packetNumber, int samples);
+};
+
+#endif // VISUSEQUENCETRACKER_H
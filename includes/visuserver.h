@@ -6,10 +6,20 @@
 #include <QSerialPort>
 #include <QRegularExpression>
 #include <QTimer>
+#include <QThread>
+#include <QElapsedTimer>
 #include "visuappinfo.h"
 #include "visusignal.h"
 #include "visudatagram.h"
+#include "visuwirecodec.h"
+#include "visulineframer.h"
 #include "visuconfiguration.h"
+#include "visuingestqueue.h"
+#include "visubulkudpsocket.h"
+#include "visusequencetracker.h"
+#include "visumetrics.h"
+#include "visustreamlog.h"
+#include "visulatencytracer.h"
 
 class VisuServer : public QObject
 {
@@ -24,39 +34,92 @@ class VisuServer : public QObject
         SERIAL_ONLY
     };
 
+    enum SerialProtocol
+    {
+        SERIAL_TEXT,
+        SERIAL_BINARY_COBS
+    };
+
     VisuServer();
+    virtual ~VisuServer();
     void start();
     void stop();
+    VisuIngestQueue* getIngestQueue();
+    quint64 getKernelDrops() const;
+    VisuMetrics getMetrics() const;
 
     private:
 
         quint16 mPort;
         enum Connectivity mConectivity;
-
-        static const quint8 DATAGRAM_SIZE = 21;
+        enum SerialProtocol mSerialProtocol;
 
         QUdpSocket mSocket;
+        QByteArray mDatagramBuffer;
+        VisuBulkUdpSocket* mBulkSocket;     // used instead of mSocket when bulk receive is enabled
         VisuConfiguration *mConfiguration;
         QTimer mTimer;
 
         QSerialPort* mSerialPort;
 
-        void updateSignal(const VisuDatagram& datagram);
-        VisuDatagram createDatagramFromBuffer(const quint8* buffer);
+        QThread mIngestThread;          // thread in which sockets are read
+        VisuIngestQueue* mIngestQueue;  // handoff of decoded datagrams to GUI thread
 
-        QByteArray mSerialBuffer;
+        void updateSignal(const VisuDatagram& datagram);
+        void updateSequencedSignal(const VisuDatagram& datagram);
+        bool parseBatchFrame(const quint8* buffer, qint64 size, quint64 source);
+        void handleDatagramBuffer(const quint8* buffer, qint64 size, quint64 source);
+        void parseVisuSerial(const char* line, int length);
+        void parseRegexSerial(const char* line, int length);
+        void parseBinarySerial(const quint8* frame, int length);
+        void setupSerialBindings();
+
+        QVector<VisuDatagram> mBatch;
+        VisuSequenceTracker mSequenceTracker;
+        QTimer mPublishTimer;
+
+        VisuLineFramer mSerialFramer;
+        QVector<quint8> mSerialFrame;   // decoded binary frame
         QRegularExpression mSerialRegex;
 
-        static const QByteArray DELIMITER;
+        // signal bound to capture group of serial regex
+        struct SerialBinding
+        {
+            quint16 signalId;
+            int captureGroup;
+            bool transform;
+            double factor;
+            double offset;
+        };
+        QVector<SerialBinding> mSerialBindings;
+        QVector<VisuDatagram> mSerialBatch;
+        QString mSerialLine;
+
+        VisuStreamRecorder mRecorder;
+        VisuStreamReplay mReplay;       // used instead of ports when replaying
+        bool mReplaying;
+        double mReplaySpeed;            // 0 replays as fast as datagrams are consumed
+        int mReplayPosition;
+        quint64 mReplayBase;            // arrival of first record
+        QTimer mReplayTimer;
+        QElapsedTimer mReplayClock;
+
+        quint64 mTraceReceived;         // trace time at which data being handled was read
+        void stampReceived();
+
+        void finishReplay();
 
     private slots:
         void pullSerial();
+        void closePorts();
+        void publishStats();
+        void startReplay();
+        void replayNext();
 
     public slots:
         void handleDatagram();
+        void handleBulkDatagrams();
         void handleSerial();
-        void parseVisuSerial();
-        void parseRegexSerial();
         void sendSerial(const QByteArray& data);
         void handleSerialError(QSerialPort::SerialPortError serialPortError);
 
@@ -10,7 +10,10 @@
 #include "visudatagram.h"
 #include "visupropertyloader.h"
 #include "visupropertymeta.h"
+#include "visuproperties.h"
 #include "visuconfigloader.h"
+#include "visusignalhistory.h"
+#include "visulatencytracer.h"
 
 class VisuInstrument;   // forward declare Instrument class
 class VisuSignal : public QObject
@@ -29,10 +32,13 @@ private:
     double  cMin;                            // Minimum signal value
     int     cSerialPlaceholder;              // Index of recevied serial string
     bool    cSerialTransform;                // Apply factor and offset to serial data
+    quint32 cHistorySize;                    // Number of samples kept in history
 
     quint64 mTimestamp;                      // Last update timestamp
     quint64 mRawValue;                       // Last value
-    QMap<QString, QString> mProperties;
+    VisuSignalHistory mHistory;              // Recently received samples
+    VisuTraceSample mTrace;                  // Stamps of last value, when latency is traced
+    VisuProperties mProperties;
     QMap<QString, VisuPropertyMeta> mPropertiesMeta;
 
     // methods
@@ -57,6 +63,9 @@ public:
     quint64 getRawValue() const;
     void set_timestamp(quint64 mTimestamp);
     quint64 getTimestamp() const;
+    const VisuSignalHistory& getHistory() const;
+    const VisuTraceSample& getTrace() const;
+    double rawToReal(quint64 rawValue) const;
     int getSerialPlaceholder() const;
     bool getSerialTransform() const;
     quint16 getId() const;
@@ -65,6 +74,7 @@ public:
     double getOffset() const;
     double getRealValue() const;
     double getNormalizedValue() const;
+    double normalize(double realValue) const;
     double getMin() const;
     double getMax() const;
     QString getName() const;
@@ -0,0 +1,65 @@
+#ifndef VISUSIGNALDISPATCH_H
+#define VISUSIGNALDISPATCH_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QPointer>
+
+class VisuSignal;
+
+/**
+ * @brief The VisuSignalDispatch class
+ * Maps 16 bit signal ids, which do not have to be contiguous, to signals
+ * in constant time. Table is split into pages of 256 ids, allocated only
+ * for ranges that contain some signal. Entries carry values needed to
+ * decode samples, so they can be used without touching the signal.
+ *
+ * Table is immutable once built. Configuration builds new one whenever
+ * signals change and hands it out as shared pointer, so that ingest
+ * thread can keep using the old one. Signal pointer may only be
+ * dereferenced in GUI thread.
+ */
+class VisuSignalDispatch
+{
+public:
+    struct Entry
+    {
+        VisuSignal* signal;
+        double factor;
+        double offset;
+        int serialPlaceholder;
+        bool serialTransform;
+
+        double rawToReal(quint64 rawValue) const
+        {
+            return rawValue * factor + offset;
+        }
+    };
+
+    VisuSignalDispatch();
+    explicit VisuSignalDispatch(const QVector<QPointer<VisuSignal>>& signalsList);
+
+    const Entry* find(quint16 signalId) const
+    {
+        const QVector<Entry>& page = mPages[signalId >> PAGE_BITS];
+        if (page.isEmpty())
+        {
+            return nullptr;
+        }
+        const Entry& entry = page[signalId & PAGE_MASK];
+        return entry.signal != nullptr ? &entry : nullptr;
+    }
+
+    const QVector<quint16>& getIds() const;
+
+private:
+    static const int PAGE_BITS = 8;
+    static const int PAGE_SIZE = 1 << PAGE_BITS;
+    static const int PAGE_MASK = PAGE_SIZE - 1;
+    static const int PAGE_COUNT = 0x10000 >> PAGE_BITS;
+
+    QVector<QVector<Entry>> mPages;
+    QVector<quint16> mIds;
+};
+
+#endif // VISUSIGNALDISPATCH_H
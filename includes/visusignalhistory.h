@@ -0,0 +1,78 @@
+#ifndef VISUSIGNALHISTORY_H
+#define VISUSIGNALHISTORY_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief The VisuSignalHistory class
+ * Fixed capacity ring buffer of received samples. Timestamps and raw
+ * values are kept in separate arrays (struct of arrays), so consumers
+ * scanning only timestamps or only values touch contiguous memory.
+ * Once full, the oldest sample is overwritten.
+ *
+ * Timestamps are kept sorted, so windows can be found by binary search.
+ * Sample older than the newest one, e.g. a reordered packet, is stored
+ * in arrival order with timestamp of the newest sample.
+ *
+ * Queries return Range objects pointing directly into the buffer. Range is
+ * valid until next append() or setCapacity(), so it should be consumed
+ * right away, in the thread that owns the signal.
+ */
+class VisuSignalHistory
+{
+public:
+
+    // Contiguous part of the buffer
+    struct Span
+    {
+        const quint64* timestamps;
+        const quint64* rawValues;
+        int size;
+    };
+
+    // Samples in chronological order. As buffer wraps around, range
+    // consists of up to two contiguous spans.
+    struct Range
+    {
+        Span first;
+        Span second;
+
+        int size() const;
+        quint64 timestampAt(int index) const;
+        quint64 rawValueAt(int index) const;
+    };
+
+    VisuSignalHistory();
+
+    void setCapacity(int capacity);
+    int capacity() const;
+    int size() const;
+    bool isEmpty() const;
+    void clear();
+    void append(quint64 timestamp, quint64 rawValue);
+
+    // Total number of samples ever appended, used as sequence number of
+    // the newest sample.
+    quint64 appended() const;
+
+    Range all() const;
+    Range last(int count) const;
+    Range since(quint64 sequence) const;
+    Range window(quint64 from, quint64 to) const;
+
+private:
+    QVector<quint64> mTimestamps;
+    QVector<quint64> mRawValues;
+    int mCapacity;
+    int mHead;          // physical index of the oldest sample
+    int mSize;
+    quint64 mAppended;
+
+    int physicalIndex(int logical) const;
+    int lowerBound(quint64 timestamp) const;
+    int upperBound(quint64 timestamp) const;
+    Range logicalRange(int begin, int end) const;
+};
+
+#endif // VISUSIGNALHISTORY_H
@@ -0,0 +1,37 @@
+#ifndef VISUSTATICLAYERCACHE_H
+#define VISUSTATICLAYERCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include "visulayer.h"
+
+/**
+ * @brief The VisuStaticLayerCache class
+ * Static layers of instruments, addressed by hash of everything that
+ * affects how they are rendered. Identical instruments which differ only
+ * in position or id find layer rendered by the first of them and share
+ * its data. Layers no instrument uses any more are dropped when
+ * new one is added.
+ */
+class VisuStaticLayerCache
+{
+public:
+    static VisuStaticLayerCache* get();
+
+    bool find(const QByteArray& key, VisuLayer& layer);
+    void insert(const QByteArray& key, const VisuLayer& layer);
+
+    quint64 getLayersShared() const;
+
+private:
+    VisuStaticLayerCache();
+
+    static VisuStaticLayerCache* instance;
+
+    QHash<QByteArray, VisuLayer> mLayers;
+    quint64 mLayersShared;
+
+    void prune();
+};
+
+#endif // VISUSTATICLAYERCACHE_H
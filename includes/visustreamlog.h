@@ -0,0 +1,87 @@
+#ifndef VISUSTREAMLOG_H
+#define VISUSTREAMLOG_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include "visudatagram.h"
+
+/**
+ * Append-only log of decoded datagrams, used to capture input streams and
+ * replay them later. All numbers are little endian.
+ *
+ * Header:
+ * magic "VREC" (4) | version (2) | record size (2) | start time, ms since epoch (8)
+ *
+ * Record:
+ * arrival, ns since start (8) | timestamp (8) | raw value (8) | signal id (2) | packet number (2)
+ *
+ * Records are only ever appended, so log cut short by a crash is still
+ * readable up to its last complete record.
+ */
+namespace VisuStreamLog
+{
+    static const quint32 MAGIC = 0x43455256;   // "VREC"
+    static const quint16 VERSION = 1;
+    static const int HEADER_SIZE = 16;
+    static const int RECORD_SIZE = 28;
+}
+
+/**
+ * @brief The VisuStreamRecorder class
+ * Writes datagrams to stream log, together with time of their arrival.
+ * Records are collected in memory and written in large chunks, so that
+ * recording does not add a system call per datagram. Used from ingest
+ * thread only.
+ */
+class VisuStreamRecorder
+{
+public:
+    VisuStreamRecorder();
+    ~VisuStreamRecorder();
+
+    bool open(const QString& path);
+    bool isOpen() const;
+    void record(const VisuDatagram& datagram);
+    void record(const VisuDatagram* datagrams, int count);
+    void flush();
+    void close();
+    quint64 getRecorded() const;
+
+    static const int FLUSH_SIZE = 64 * 1024;
+
+private:
+    QFile mFile;
+    QByteArray mBuffer;
+    QElapsedTimer mClock;
+    quint64 mRecorded;
+};
+
+/**
+ * @brief The VisuStreamReplay class
+ * Read access to stream log. File is mapped, records are decoded on
+ * demand.
+ */
+class VisuStreamReplay
+{
+public:
+    VisuStreamReplay();
+    ~VisuStreamReplay();
+
+    bool open(const QString& path);
+    void close();
+    int getCount() const;
+    quint64 getStartTime() const;
+    quint64 getArrival(int index) const;
+    VisuDatagram getDatagram(int index) const;
+
+private:
+    QFile mFile;
+    const uchar* mData;
+    int mCount;
+
+    const uchar* recordAt(int index) const;
+};
+
+#endif // VISUSTREAMLOG_H
@@ -6,6 +6,7 @@
 #include <QMap>
 #include "visupropertyloader.h"
 #include "visupropertymeta.h"
+#include "visuproperties.h"
 
 class VisuWidget : public QWidget
 {
@@ -21,6 +22,7 @@ public:
     {
         setObjectName(VisuWidget::OBJECT_NAME);
         mActive = false;
+        mProperties.setSchema(VisuPropertySchema::compile(properties.value(KEY_TYPE), metaProperties));
     }
 
     virtual bool updateProperties(const QString &key, const QString &value);
@@ -34,7 +36,7 @@ public:
     static const QString KEY_NAME;
     static const QString KEY_TYPE;
 
-    QMap<QString, QString>& getProperties();
+    const QMap<QString, QString>& getProperties() const;
     void setPropertiesMeta(QMap<QString, VisuPropertyMeta> meta);
     QMap<QString, VisuPropertyMeta> getPropertiesMeta();
     QString getName();
@@ -67,7 +69,7 @@ signals:
 protected:
 
     // properties map
-    QMap<QString, QString> mProperties;
+    VisuProperties mProperties;
     QMap<QString, VisuPropertyMeta> mPropertiesMeta;
 
     quint16 cId;
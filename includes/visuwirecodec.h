@@ -0,0 +1,53 @@
+#ifndef VISUWIRECODEC_H
+#define VISUWIRECODEC_H
+
+#include <QtGlobal>
+#include "visudatagram.h"
+
+/**
+ * Decoding of datagrams as they appear on the wire. Checksums are
+ * verified over wire bytes and big endian fields are swapped with SIMD
+ * where available. Implementation is picked at runtime: AVX2, SSE2 or
+ * scalar fallback.
+ *
+ * Datagram layout (big endian):
+ * signal id (2) | packet number (2) | timestamp (8) | raw value (8) | checksum (1)
+ *
+ * Batched frame layout (big endian):
+ * magic "VB" (2) | version (1) | packet number (2) | record count (2)
+ * followed by records and a single XOR checksum byte over everything
+ * before it. Record layout:
+ * signal id (2) | timestamp (8) | raw value (8)
+ *
+ * Text datagram, as sent over serial port, in decimal:
+ * >signal id packet number raw value timestamp checksum
+ *
+ * Binary serial frames carry datagram or batched frame, COBS encoded and
+ * terminated by zero byte.
+ */
+namespace VisuWireCodec
+{
+    static const int DATAGRAM_SIZE = 21;
+    static const int RECORD_SIZE = 18;
+    static const quint8 BATCH_MAGIC_FIRST = 'V';
+    static const quint8 BATCH_MAGIC_SECOND = 'B';
+    static const quint8 BATCH_VERSION = 1;
+    static const int BATCH_HEADER_SIZE = 7;
+
+    quint8 xorChecksum(const quint8* data, qint64 size);
+    bool decodeDatagram(const quint8* wire, VisuDatagram& datagram);
+    void decodeRecords(const quint8* records, int count, quint16 packetNumber, VisuDatagram* datagrams);
+    bool isBatchFrame(const quint8* frame, qint64 size);
+    int decodeBatchHeader(const quint8* frame, qint64 size, quint16& packetNumber);
+    bool decodeText(const char* begin, const char* end, VisuDatagram& datagram);
+    void encodeDatagram(const VisuDatagram& datagram, quint8* wire);
+    int encodeBatch(const VisuDatagram* datagrams, int count, quint16 packetNumber, quint8* frame);
+    int getBatchSize(int count);
+    int encodeCobs(const quint8* data, int size, quint8* encoded);
+    int decodeCobs(const quint8* encoded, int size, quint8* data);
+    int getCobsMaxSize(int size);
+    const char* getImplementation();
+    bool useImplementation(const char* name);
+}
+
+#endif // VISUWIRECODEC_H
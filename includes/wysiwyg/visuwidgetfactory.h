@@ -12,6 +12,8 @@ public:
                                     QString type);
     static VisuWidget* createWidget(QWidget* parent,
                                     QMap<QString, QString> properties);
+    static VisuWidget* constructWidget(QWidget* parent,
+                                       const QMap<QString, QString>& properties);
 };
 
 #endif // VISUWIDGETFACTORY_H
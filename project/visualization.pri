@@ -0,0 +1,115 @@
+#-------------------------------------------------
+#
+# Sources shared by the application and test projects
+#
+#-------------------------------------------------
+
+QT       += core gui network serialport
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+QMAKE_CXXFLAGS += -std=c++0x
+QMAKE_CXXFLAGS += -Wall
+
+VPATH += $$PWD/../src
+INCLUDEPATH += $$PWD/../includes
+INCLUDEPATH += $$PWD/../includes/controls
+INCLUDEPATH += $$PWD/../includes/exceptions
+INCLUDEPATH += $$PWD/../includes/instruments
+
+
+SOURCES += $$PWD/../src/mainwindow.cpp \
+    $$PWD/../src/visuwidget.cpp \
+    $$PWD/../src/visuinstrument.cpp \
+    $$PWD/../src/visusignal.cpp \
+    $$PWD/../src/visuserver.cpp \
+    $$PWD/../src/visuapplication.cpp \
+    $$PWD/../src/visuconfiguration.cpp \
+    $$PWD/../src/instruments/instanalog.cpp \
+    $$PWD/../src/instruments/instdigital.cpp \
+    $$PWD/../src/instruments/instlinear.cpp \
+    $$PWD/../src/instruments/insttimeplot.cpp \
+    $$PWD/../src/exceptions/configloadexception.cpp \
+    $$PWD/../src/instruments/instxyplot.cpp \
+    $$PWD/../src/instruments/instled.cpp \
+    $$PWD/../src/visupropertyloader.cpp \
+    $$PWD/../src/controls/ctrlbutton.cpp \
+    $$PWD/../src/controls/ctrlslider.cpp \
+    $$PWD/../src/statics/staticimage.cpp \
+    $$PWD/../src/visuconfigloader.cpp \
+    $$PWD/../src/visucompiledconfig.cpp \
+    $$PWD/../src/visubulkudpsocket.cpp \
+    $$PWD/../src/visusequencetracker.cpp \
+    $$PWD/../src/visusignaldispatch.cpp \
+    $$PWD/../src/visuwirecodec.cpp \
+    $$PWD/../src/visulineframer.cpp \
+    $$PWD/../src/visustreamlog.cpp \
+    $$PWD/../src/visulatencytracer.cpp \
+    $$PWD/../src/visulatencyoverlay.cpp \
+    $$PWD/../src/visustaticlayercache.cpp \
+    $$PWD/../src/visulayer.cpp \
+    $$PWD/../src/wysiwyg/stage.cpp \
+    $$PWD/../src/wysiwyg/visuwidgetfactory.cpp \
+    $$PWD/../src/visumisc.cpp \
+    $$PWD/../src/wysiwyg/editsignal.cpp \
+    $$PWD/../src/wysiwyg/editconfiguration.cpp \
+    $$PWD/../src/visucontrol.cpp \
+    $$PWD/../src/visupropertymeta.cpp \
+    $$PWD/../src/wysiwyg/visupropertieshelper.cpp \
+    $$PWD/../src/visuappinfo.cpp \
+    $$PWD/../src/visudatagram.cpp \
+    $$PWD/../src/visuingestqueue.cpp \
+    $$PWD/../src/visurenderscheduler.cpp \
+    $$PWD/../src/visusignalhistory.cpp \
+    $$PWD/../src/visupropertyschema.cpp \
+    $$PWD/../src/visuproperties.cpp
+
+HEADERS  += $$PWD/../includes/mainwindow.h \
+    $$PWD/../includes/visuinstrument.h \
+    $$PWD/../includes/visusignal.h \
+    $$PWD/../includes/visuserver.h \
+    $$PWD/../includes/visudatagram.h \
+    $$PWD/../includes/visuapplication.h \
+    $$PWD/../includes/visuconfiguration.h \
+    $$PWD/../includes/instruments/instanalog.h \
+    $$PWD/../includes/instruments/instdigital.h \
+    $$PWD/../includes/instruments/instlinear.h \
+    $$PWD/../includes/instruments/insttimeplot.h \
+    $$PWD/../includes/exceptions/configloadexception.h \
+    $$PWD/../includes/instruments/instxyplot.h \
+    $$PWD/../includes/instruments/instled.h \
+    $$PWD/../includes/visuwidget.h \
+    $$PWD/../includes/statics/staticimage.h \
+    $$PWD/../includes/visuconfigloader.h \
+    $$PWD/../includes/visucompiledconfig.h \
+    $$PWD/../includes/visubulkudpsocket.h \
+    $$PWD/../includes/visusequencetracker.h \
+    $$PWD/../includes/visumetrics.h \
+    $$PWD/../includes/visusignaldispatch.h \
+    $$PWD/../includes/visuwirecodec.h \
+    $$PWD/../includes/visulineframer.h \
+    $$PWD/../includes/visustreamlog.h \
+    $$PWD/../includes/visulatencytracer.h \
+    $$PWD/../includes/visulatencyoverlay.h \
+    $$PWD/../includes/visustaticlayercache.h \
+    $$PWD/../includes/visulayer.h \
+    $$PWD/../includes/wysiwyg/stage.h \
+    $$PWD/../includes/wysiwyg/visuwidgetfactory.h \
+    $$PWD/../includes/visumisc.h \
+    $$PWD/../includes/wysiwyg/editsignal.h \
+    $$PWD/../includes/wysiwyg/editconfiguration.h \
+    $$PWD/../includes/visucontrol.h \
+    $$PWD/../includes/controls/ctrlbutton.h \
+    $$PWD/../includes/controls/ctrlslider.h \
+    $$PWD/../includes/visupropertymeta.h \
+    $$PWD/../includes/wysiwyg/visupropertieshelper.h \
+    $$PWD/../includes/visupropertyloader.h \
+    $$PWD/../includes/visuappinfo.h \
+    $$PWD/../includes/visuringbuffer.h \
+    $$PWD/../includes/visuingestqueue.h \
+    $$PWD/../includes/visurenderscheduler.h \
+    $$PWD/../includes/visusignalhistory.h \
+    $$PWD/../includes/visupropertyschema.h \
+    $$PWD/../includes/visuproperties.h
+
+FORMS    += $$PWD/../src/mainwindow.ui
@@ -0,0 +1,523 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QHostAddress>
+#include <QUdpSocket>
+#include <QDateTime>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include "visudatagram.h"
+#include "visuwirecodec.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+/**
+ * Load generator for VisuServer. Sends generated signals over UDP as
+ * single datagrams or batched frames, optionally several per sendmmsg
+ * call, at given rate or as fast as possible, and reports achieved send
+ * rate. Wire format is produced by VisuWireCodec, same as decoded by the
+ * server.
+ *
+ * loadgen --signals 64 --rate 1000 --waveform sine --batch 32 --mmsg 16
+ *
+ * Signals can run at different rates, given as a list that is repeated
+ * over signals. Here even signals are sent at 10 Hz and odd at 1 kHz:
+ *
+ * loadgen --signals 64 --rate 10,1000
+ */
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // largest payload of IPv4 UDP datagram
+    const int MAX_UDP_PAYLOAD = 65507;
+    const int MAX_BATCH = (MAX_UDP_PAYLOAD - VisuWireCodec::BATCH_HEADER_SIZE - 1) / VisuWireCodec::RECORD_SIZE;
+    const int MAX_MESSAGES = 1024;
+    const double PI = 3.14159265358979323846;
+
+    enum Waveform
+    {
+        WAVE_SINE,
+        WAVE_STEP,
+        WAVE_NOISE,
+        WAVE_RAMP
+    };
+
+    const char* const WAVEFORM_NAMES[] = { "sine", "step", "noise", "ramp" };
+
+    struct Options
+    {
+        QHostAddress host;
+        quint16 port;
+        int signalCount;
+        quint16 firstId;
+        double rate;            // samples per second of the fastest signal, 0 sends as fast as possible
+        std::vector<double> rates;  // samples per second of each signal
+        Waveform waveform;
+        double period;          // seconds
+        quint64 minimum;
+        quint64 maximum;
+        int burst;              // samples of each signal sent back to back
+        int batch;              // records per batched frame, 1 sends single datagrams
+        int messages;           // datagrams per send call
+        double duration;        // seconds, 0 runs until killed
+        double reportInterval;  // seconds
+    };
+
+    /**
+     * @brief The Generator class
+     * Computes raw values of signals. Signals get evenly spread phases, so
+     * that they do not all carry the same value.
+     */
+    class Generator
+    {
+    public:
+        Generator(const Options& options) : mOptions(options),
+                                            mRandom(1),
+                                            mNoise(options.minimum, options.maximum)
+        {
+        }
+
+        quint64 value(int signalIndex, double time)
+        {
+            double phase = time / mOptions.period + (double)signalIndex / mOptions.signalCount;
+            phase -= std::floor(phase);
+            double span = (double)(mOptions.maximum - mOptions.minimum);
+
+            switch (mOptions.waveform)
+            {
+            case WAVE_SINE:
+                return mOptions.minimum + (quint64)(span * (0.5 + 0.5 * std::sin(2 * PI * phase)));
+            case WAVE_STEP:
+                return phase < 0.5 ? mOptions.minimum : mOptions.maximum;
+            case WAVE_NOISE:
+                return mNoise(mRandom);
+            case WAVE_RAMP:
+                return mOptions.minimum + (quint64)(span * phase);
+            }
+            return mOptions.minimum;
+        }
+
+    private:
+        const Options& mOptions;
+        std::mt19937_64 mRandom;
+        std::uniform_int_distribution<quint64> mNoise;
+    };
+
+    /**
+     * @brief The Sender class
+     * Collects encoded frames in a slab and sends them, up to given number
+     * per sendmmsg call. Other platforms send frames one by one.
+     */
+    class Sender
+    {
+    public:
+        Sender(const QHostAddress& host, quint16 port, int messages, int frameSize) :
+            mHost(host),
+            mPort(port),
+            mMessages(messages),
+            mFrameSize(frameSize),
+            mSlab((size_t)messages * frameSize),
+            mSizes(messages),
+            mPending(0),
+            mFrames(0),
+            mBytes(0),
+            mErrors(0)
+        {
+#ifdef Q_OS_LINUX
+            mFd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            if (mFd < 0)
+            {
+                qFatal("Failed to create UDP socket: %s", strerror(errno));
+            }
+
+            memset(&mAddress, 0, sizeof(mAddress));
+            mAddress.sin_family = AF_INET;
+            mAddress.sin_port = htons(port);
+            mAddress.sin_addr.s_addr = htonl(host.toIPv4Address());
+
+            mHeaders.resize(messages);
+            mVectors.resize(messages);
+#endif
+        }
+
+        ~Sender()
+        {
+#ifdef Q_OS_LINUX
+            ::close(mFd);
+#endif
+        }
+
+        quint8* nextFrame()
+        {
+            if (mPending == mMessages)
+            {
+                flush();
+            }
+            return mSlab.data() + (size_t)mPending * mFrameSize;
+        }
+
+        void commit(int size)
+        {
+            mSizes[mPending++] = size;
+        }
+
+        void flush()
+        {
+#ifdef Q_OS_LINUX
+            for (int i = 0; i < mPending; ++i)
+            {
+                mVectors[i].iov_base = mSlab.data() + (size_t)i * mFrameSize;
+                mVectors[i].iov_len = mSizes[i];
+
+                msghdr& header = mHeaders[i].msg_hdr;
+                memset(&header, 0, sizeof(header));
+                header.msg_name = &mAddress;
+                header.msg_namelen = sizeof(mAddress);
+                header.msg_iov = &mVectors[i];
+                header.msg_iovlen = 1;
+            }
+
+            int offset = 0;
+            while (offset < mPending)
+            {
+                int count = sendmmsg(mFd, mHeaders.data() + offset, mPending - offset, 0);
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    // e.g. nobody listening or out of buffers, frame is lost
+                    ++mErrors;
+                    ++offset;
+                    continue;
+                }
+
+                for (int i = offset; i < offset + count; ++i)
+                {
+                    mBytes += mSizes[i];
+                }
+                mFrames += count;
+                offset += count;
+            }
+#else
+            for (int i = 0; i < mPending; ++i)
+            {
+                qint64 written = mSocket.writeDatagram((const char*)mSlab.data() + (size_t)i * mFrameSize,
+                                                       mSizes[i], mHost, mPort);
+                if (written < 0)
+                {
+                    ++mErrors;
+                    continue;
+                }
+                mBytes += written;
+                ++mFrames;
+            }
+#endif
+            mPending = 0;
+        }
+
+        quint64 getFrames() const
+        {
+            return mFrames;
+        }
+
+        quint64 getBytes() const
+        {
+            return mBytes;
+        }
+
+        quint64 getErrors() const
+        {
+            return mErrors;
+        }
+
+    private:
+        QHostAddress mHost;
+        quint16 mPort;
+        int mMessages;
+        int mFrameSize;
+        std::vector<quint8> mSlab;
+        std::vector<int> mSizes;
+        int mPending;
+
+        quint64 mFrames;
+        quint64 mBytes;
+        quint64 mErrors;
+
+#ifdef Q_OS_LINUX
+        int mFd;
+        sockaddr_in mAddress;
+        std::vector<mmsghdr> mHeaders;
+        std::vector<iovec> mVectors;
+#else
+        QUdpSocket mSocket;
+#endif
+    };
+
+    bool parseOptions(const QCoreApplication& app, Options& options)
+    {
+        QCommandLineParser parser;
+        parser.setApplicationDescription("Sends generated signals to visualization over UDP.");
+        parser.addHelpOption();
+        parser.addOptions({
+            { "host", "Destination IPv4 address.", "address", "127.0.0.1" },
+            { "port", "Destination UDP port.", "port", "3334" },
+            { "signals", "Number of signals.", "count", "1" },
+            { "first-id", "Id of the first signal, others follow.", "id", "0" },
+            { "rate", "Samples per second of each signal, 0 for maximum. Comma separated list is repeated over signals.", "hz", "10" },
+            { "waveform", "sine, step, noise or ramp.", "waveform", "sine" },
+            { "period", "Waveform period in seconds.", "seconds", "1" },
+            { "min", "Minimum raw value.", "value", "0" },
+            { "max", "Maximum raw value.", "value", "100" },
+            { "burst", "Samples of each signal sent back to back.", "count", "1" },
+            { "batch", "Records per batched frame, 1 sends single datagrams.", "count", "1" },
+            { "mmsg", "Datagrams per sendmmsg call.", "count", "1" },
+            { "duration", "Seconds to run, 0 runs until killed.", "seconds", "0" },
+            { "report", "Seconds between rate reports.", "seconds", "1" }
+        });
+        parser.process(app);
+
+        int waveform = WAVE_RAMP;
+        while (waveform >= 0 && parser.value("waveform") != WAVEFORM_NAMES[waveform])
+        {
+            --waveform;
+        }
+        if (waveform < 0)
+        {
+            qDebug("Unknown waveform %s.", parser.value("waveform").toStdString().c_str());
+            return false;
+        }
+
+        if (!options.host.setAddress(parser.value("host"))
+            || options.host.protocol() != QAbstractSocket::IPv4Protocol)
+        {
+            qDebug("Invalid IPv4 address %s.", parser.value("host").toStdString().c_str());
+            return false;
+        }
+
+        options.port = parser.value("port").toUShort();
+        options.signalCount = qMax(parser.value("signals").toInt(), 1);
+        options.firstId = parser.value("first-id").toUShort();
+
+        QStringList rates = parser.value("rate").split(',');
+        options.rate = 0.0;
+        for (int s = 0; s < options.signalCount; ++s)
+        {
+            bool ok;
+            double rate = rates[s % rates.size()].toDouble(&ok);
+            if (!ok || rate < 0.0)
+            {
+                qDebug("Invalid rate %s.", parser.value("rate").toStdString().c_str());
+                return false;
+            }
+            options.rates.push_back(rate);
+            options.rate = qMax(options.rate, rate);
+        }
+        // signals are paced against each other, maximum rate applies to all
+        if (options.rate > 0 && std::find(options.rates.begin(), options.rates.end(), 0.0) != options.rates.end())
+        {
+            qDebug("Rate 0 cannot be mixed with other rates.");
+            return false;
+        }
+
+        options.waveform = (Waveform)waveform;
+        options.period = qMax(parser.value("period").toDouble(), 0.001);
+        options.minimum = parser.value("min").toULongLong();
+        options.maximum = qMax(parser.value("max").toULongLong(), options.minimum);
+        options.burst = qMax(parser.value("burst").toInt(), 1);
+        options.batch = qBound(1, parser.value("batch").toInt(), MAX_BATCH);
+        options.messages = qBound(1, parser.value("mmsg").toInt(), MAX_MESSAGES);
+        options.duration = qMax(parser.value("duration").toDouble(), 0.0);
+        options.reportInterval = qMax(parser.value("report").toDouble(), 0.1);
+        return true;
+    }
+
+    QString describeRate(const Options& options)
+    {
+        if (options.rate == 0)
+        {
+            return "maximum rate";
+        }
+        double slowest = *std::min_element(options.rates.begin(), options.rates.end());
+        if (slowest == options.rate)
+        {
+            return QString("%1 Hz").arg(options.rate);
+        }
+        return QString("%1 to %2 Hz").arg(slowest).arg(options.rate);
+    }
+
+    double seconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double>(duration).count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    Options options;
+    if (!parseOptions(app, options))
+    {
+        return 1;
+    }
+
+    int frameSize = options.batch > 1 ? VisuWireCodec::getBatchSize(options.batch) : VisuWireCodec::DATAGRAM_SIZE;
+    Sender sender(options.host, options.port, options.messages, frameSize);
+    Generator generator(options);
+
+    qDebug("Sending %d signals at %s, %s, batch %d, %d datagrams per call, to %s:%d.",
+           options.signalCount,
+           describeRate(options).toStdString().c_str(),
+           WAVEFORM_NAMES[options.waveform],
+           options.batch,
+           options.messages,
+           options.host.toString().toStdString().c_str(),
+           options.port);
+
+    std::vector<quint16> packetNumbers(options.signalCount, 0);
+    std::vector<quint64> sent(options.signalCount, 0);
+    std::vector<quint64> due(options.signalCount, 0);
+    std::vector<VisuDatagram> records;
+    records.reserve(options.batch);
+    quint16 framePacketNumber = 0;
+
+    // one tick sends burst samples of the fastest signal, slower ones what they are due
+    Clock::duration tick = options.rate > 0
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.burst / options.rate))
+            : Clock::duration::zero();
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start;
+    Clock::time_point lastReport = start;
+    quint64 ticks = 0;
+    quint64 samples = 0;
+    quint64 lastSamples = 0;
+    quint64 lastFrames = 0;
+    quint64 lastBytes = 0;
+
+    auto flushRecords = [&]()
+    {
+        if (!records.empty())
+        {
+            int size = VisuWireCodec::encodeBatch(records.data(), (int)records.size(), framePacketNumber++, sender.nextFrame());
+            sender.commit(size);
+            records.clear();
+        }
+    };
+
+    while (true)
+    {
+        Clock::time_point now = Clock::now();
+        double elapsed = seconds(now - start);
+        if (options.duration > 0 && elapsed >= options.duration)
+        {
+            break;
+        }
+
+        quint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+        for (int s = 0; s < options.signalCount; ++s)
+        {
+            due[s] = options.rate > 0
+                    ? (quint64)std::floor((ticks + 1) * options.burst * options.rates[s] / options.rate + 1e-9)
+                    : sent[s] + options.burst;
+        }
+
+        // samples of different signals are interleaved as in one burst
+        for (bool pending = true; pending; )
+        {
+            pending = false;
+            for (int s = 0; s < options.signalCount; ++s)
+            {
+                if (sent[s] == due[s])
+                {
+                    continue;
+                }
+                pending = true;
+
+                // paced samples are evenly spaced in signal time, even if sent in bursts
+                double time = options.rate > 0 ? sent[s] / options.rates[s] : elapsed;
+                ++sent[s];
+                ++samples;
+
+                VisuDatagram datagram;
+                datagram.signalId = options.firstId + s;
+                datagram.packetNumber = packetNumbers[s]++;
+                datagram.timestamp = timestamp;
+                datagram.rawValue = generator.value(s, time);
+                datagram.checksum = 0x0;
+
+                if (options.batch > 1)
+                {
+                    records.push_back(datagram);
+                    if ((int)records.size() == options.batch)
+                    {
+                        flushRecords();
+                    }
+                }
+                else
+                {
+                    VisuWireCodec::encodeDatagram(datagram, sender.nextFrame());
+                    sender.commit(VisuWireCodec::DATAGRAM_SIZE);
+                }
+            }
+        }
+        flushRecords();
+        sender.flush();
+        ++ticks;
+
+        now = Clock::now();
+        double sinceReport = seconds(now - lastReport);
+        if (sinceReport >= options.reportInterval)
+        {
+            qDebug("%8.1f s: %10.0f samples/s %10.0f datagrams/s %8.2f MB/s, %llu send errors",
+                   seconds(now - start),
+                   (samples - lastSamples) / sinceReport,
+                   (sender.getFrames() - lastFrames) / sinceReport,
+                   (sender.getBytes() - lastBytes) / sinceReport / 1e6,
+                   sender.getErrors());
+            lastReport = now;
+            lastSamples = samples;
+            lastFrames = sender.getFrames();
+            lastBytes = sender.getBytes();
+        }
+
+        if (tick != Clock::duration::zero())
+        {
+            deadline += tick;
+            if (deadline > now)
+            {
+                std::this_thread::sleep_until(deadline);
+            }
+            else if (now - deadline > std::chrono::seconds(1))
+            {
+                // too far behind, give up catching up instead of sending one long burst
+                deadline = now;
+            }
+        }
+    }
+
+    double elapsed = qMax(seconds(Clock::now() - start), 1e-9);
+    qDebug("Sent %llu samples in %llu datagrams (%llu bytes) in %.2f s: %.0f samples/s, %.0f datagrams/s, %llu send errors.",
+           samples,
+           sender.getFrames(),
+           sender.getBytes(),
+           elapsed,
+           samples / elapsed,
+           sender.getFrames() / elapsed,
+           sender.getErrors());
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# UDP load generator
+#
+#-------------------------------------------------
+
+QT       += network
+QT       -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+TARGET = loadgen
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../includes
+
+SOURCES += loadgen.cpp \
+    ../../src/visuwirecodec.cpp \
+    ../../src/visudatagram.cpp
@@ -72,6 +72,37 @@ class Sender(object):
 
 
 
+    def prepareBatchPackage(self, signals, packetNumber):
+
+        # header: magic, version, packet number and record count
+        package = [ord('V'), ord('B'), 0x01, \
+                   (packetNumber >> 8) & 0xFF, packetNumber & 0xFF, \
+                   (len(signals) >> 8) & 0xFF, len(signals) & 0xFF]
+
+        # records: signal id, timestamp and value
+        for signal in signals:
+            package.append((signal.id >> 8) & 0xFF)
+            package.append(signal.id & 0xFF)
+            timestamp = int(signal.timestamp * 100)
+            for i in range(0, 8):
+                package.append((timestamp >> ((7 - i) * 8)) & 0xFF)
+            for i in range(0, 8):
+                package.append((signal.raw >> ((7 - i) * 8)) & 0xFF)
+
+        # single checksum for the whole frame
+        checksum = 0x00
+        for x in package:
+            checksum ^= x
+        package.append(checksum)
+
+        return ''.join(chr(x) for x in package)
+
+    def sendBatch(self, signals, packetNumber = 0):
+        message = self.prepareBatchPackage(signals, packetNumber)
+        self.sock.sendto(message, (self.server.ip, self.server.port))
+
+        print "Sending batch of {} values".format(len(signals))
+
     def send(self, signal):
         message = self.preparePackage(signal)
         self.sock.sendto(message, (self.server.ip, self.server.port))
@@ -43,7 +43,7 @@ void CtrlButton::setupButton(QWidget* parent)
 
 bool CtrlButton::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     CtrlButton::loadProperties();
     return CtrlButton::refresh(key);
 }
@@ -52,15 +52,15 @@ void CtrlButton::loadProperties()
 {
     VisuControl::loadProperties();
 
-    GET_PROPERTY(cActionMessage, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cCss, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorBackground, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorForeground, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorBorder, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cBorderRadius, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cFontSize, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cFontType, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cBorderThickness, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cActionMessage, mProperties);
+    GET_PROPERTY(cCss, mProperties);
+    GET_PROPERTY(cColorBackground, mProperties);
+    GET_PROPERTY(cColorForeground, mProperties);
+    GET_PROPERTY(cColorBorder, mProperties);
+    GET_PROPERTY(cBorderRadius, mProperties);
+    GET_PROPERTY(cFontSize, mProperties);
+    GET_PROPERTY(cFontType, mProperties);
+    GET_PROPERTY(cBorderThickness, mProperties);
 }
 
 void CtrlButton::setup(QWidget *parent)
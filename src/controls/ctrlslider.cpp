@@ -33,7 +33,7 @@ void CtrlSlider::setupSlider(QWidget* parent)
 
 bool CtrlSlider::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     CtrlSlider::loadProperties();
     return CtrlSlider::refresh(key);
 }
@@ -42,17 +42,17 @@ void CtrlSlider::loadProperties()
 {
     VisuControl::loadProperties();
 
-    GET_PROPERTY(cRange, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMessage, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cCss, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorBackground, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorForeground, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorBorder, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cBorderRadius, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cFontSize, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cFontType, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cBorderThickness, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cHorizontal, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cRange, mProperties);
+    GET_PROPERTY(cMessage, mProperties);
+    GET_PROPERTY(cCss, mProperties);
+    GET_PROPERTY(cColorBackground, mProperties);
+    GET_PROPERTY(cColorForeground, mProperties);
+    GET_PROPERTY(cColorBorder, mProperties);
+    GET_PROPERTY(cBorderRadius, mProperties);
+    GET_PROPERTY(cFontSize, mProperties);
+    GET_PROPERTY(cFontType, mProperties);
+    GET_PROPERTY(cBorderThickness, mProperties);
+    GET_PROPERTY(cHorizontal, mProperties);
 }
 
 void CtrlSlider::setup(QWidget *parent)
@@ -85,7 +85,7 @@ bool CtrlSlider::refresh(const QString& key)
     {
         mSlider->setOrientation(cHorizontal ? Qt::Horizontal : Qt::Vertical);
         std::swap(cWidth, cHeight);
-        std::swap(mProperties[KEY_WIDTH], mProperties[KEY_HEIGHT]);
+        mProperties.swap(KEY_WIDTH, KEY_HEIGHT);
         changed = true;
     }
 
@@ -9,7 +9,7 @@ const QString InstAnalog::TAG_NAME = "ANALOG";
 
 bool InstAnalog::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     InstAnalog::loadProperties();
     return VisuInstrument::refresh(key);
 }
@@ -19,29 +19,29 @@ void InstAnalog::loadProperties()
     VisuInstrument::loadProperties();
 
     // custom properties initializer
-    GET_PROPERTY(cColorCircle, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cCircleRadius, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cLineThickness, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorLen, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMinorLen, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorCnt, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMinorCnt, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cArrowWidth, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cDrawCircle, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cLabelRadius, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cAngleStart, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cAngleEnd, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cNameX, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cNameY, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cOffsetX, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cOffsetY, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cShowLabel, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cDivisionRadius, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cArrowLen, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cLabelMultiplier, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cRotateLabels, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cCircleOffset, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cCircleTrim, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cColorCircle, mProperties);
+    GET_PROPERTY(cCircleRadius, mProperties);
+    GET_PROPERTY(cLineThickness, mProperties);
+    GET_PROPERTY(cMajorLen, mProperties);
+    GET_PROPERTY(cMinorLen, mProperties);
+    GET_PROPERTY(cMajorCnt, mProperties);
+    GET_PROPERTY(cMinorCnt, mProperties);
+    GET_PROPERTY(cArrowWidth, mProperties);
+    GET_PROPERTY(cDrawCircle, mProperties);
+    GET_PROPERTY(cLabelRadius, mProperties);
+    GET_PROPERTY(cAngleStart, mProperties);
+    GET_PROPERTY(cAngleEnd, mProperties);
+    GET_PROPERTY(cNameX, mProperties);
+    GET_PROPERTY(cNameY, mProperties);
+    GET_PROPERTY(cOffsetX, mProperties);
+    GET_PROPERTY(cOffsetY, mProperties);
+    GET_PROPERTY(cShowLabel, mProperties);
+    GET_PROPERTY(cDivisionRadius, mProperties);
+    GET_PROPERTY(cArrowLen, mProperties);
+    GET_PROPERTY(cLabelMultiplier, mProperties);
+    GET_PROPERTY(cRotateLabels, mProperties);
+    GET_PROPERTY(cCircleOffset, mProperties);
+    GET_PROPERTY(cCircleTrim, mProperties);
 
     mTagName = InstAnalog::TAG_NAME;
 }
@@ -51,7 +51,6 @@ void InstAnalog::renderStatic(QPainter* painter)
     clear(painter);
     setPen(painter, cColorStatic, cLineThickness);
     setFont(painter);
-    setupProperties();
 
     if (cDrawCircle)
     {
@@ -229,10 +228,28 @@ void InstAnalog::initDivisionProperties(int length)
     mEndPointY = mEndLen * mAngleCos + mCenterY;
 }
 
-void InstAnalog::calculateAngleOffset()
+double InstAnalog::getAngleStepsPerRadian()
+{
+    return qMax<int>(cArrowLen, 1);
+}
+
+/**
+ * @brief InstAnalog::getVisualKey
+ * Pointer angle is quantized to steps in which its tip moves by about
+ * one pixel, so values closer than that are drawn the same.
+ */
+bool InstAnalog::getVisualKey(quint64& key)
 {
     double value = mSignal->getNormalizedValue();
     double angleValue = (2 * PI - cAngleStart - cAngleEnd) * value + cAngleStart;
+    mPointerStep = qRound64(angleValue * getAngleStepsPerRadian());
+    key = (quint64)mPointerStep;
+    return true;
+}
+
+void InstAnalog::calculateAngleOffset()
+{
+    double angleValue = mPointerStep / getAngleStepsPerRadian();
     mAngleSin = qSin(angleValue);
     mAngleCos = qCos(angleValue);
 }
@@ -243,15 +260,93 @@ void InstAnalog::setupProperties()
     mCenterY = cHeight / 2;
 }
 
-void InstAnalog::renderDynamic(QPainter* painter)
-{    
-    setPen(painter, cColorForeground);
-    setBrush(painter, cColorForeground);
+bool InstAnalog::prepareStatic()
+{
+    setupProperties();
+
+    // sprites of other configurations are left to age out of the cache
+    mNeedleKey = getStaticKey();
+    mNeedleKey.append(mPixmap.isRaster() ? 'r' : 'p');
+    return true;
+}
+
+/**
+ * @brief InstAnalog::prepareDynamic
+ * Pointer is the only dynamic part, so its sprite bounds are all that
+ * has to be repainted.
+ */
+QRect InstAnalog::prepareDynamic()
+{
+    mNeedle = getNeedleSprite();
+    return QRect(mNeedle.origin, mNeedle.layer.size());
+}
+
+/**
+ * @brief InstAnalog::getNeedleSprites
+ * Sprites of all analog instruments, by shape key and angle step, so
+ * identical instruments share them and memory is bounded by
+ * NEEDLE_CACHE_BYTES however many instruments there are. Never
+ * destroyed, like other caches of rendered layers.
+ */
+QCache<QByteArray, InstAnalog::NeedleSprite>& InstAnalog::getNeedleSprites()
+{
+    static QCache<QByteArray, NeedleSprite>* sprites = new QCache<QByteArray, NeedleSprite>(NEEDLE_CACHE_BYTES);
+    return *sprites;
+}
+
+/**
+ * @brief InstAnalog::getNeedleSprite
+ * Pointer shape only depends on configuration and angle step, so every
+ * step is rasterized once, with antialiased edge, and reused afterwards.
+ * Sprite is returned by value, its layer shares data with cached one.
+ */
+InstAnalog::NeedleSprite InstAnalog::getNeedleSprite()
+{
+    QByteArray key = mNeedleKey;
+    key.append((const char*)&mPointerStep, sizeof(mPointerStep));
+
+    QCache<QByteArray, NeedleSprite>& sprites = getNeedleSprites();
+    NeedleSprite* cached = sprites.object(key);
+    if (cached != nullptr)
+    {
+        return *cached;
+    }
+
     calculateAngleOffset();
-    drawTrianglePointer(painter);
+    updateTrianglePointer();
+
+    // widened by antialiased edge
+    QRect bounds = mPointer.boundingRect().toAlignedRect().adjusted(-2, -2, 2, 2);
+    VisuLayer layer = createLayer(bounds.width(), bounds.height());
+    layer.fill(Qt::transparent);
+
+    QPainter painter(layer.device());
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(-bounds.topLeft());
+    setPen(&painter, cColorForeground);
+    setBrush(&painter, cColorForeground);
+    painter.drawPolygon(mPointer);
+    painter.end();
+
+    NeedleSprite sprite;
+    sprite.layer = layer;
+    sprite.origin = bounds.topLeft();
+
+    // sprite larger than whole cache is just not kept
+    int cost = layer.byteCount();
+    if (cost <= sprites.maxCost())
+    {
+        sprites.insert(key, new NeedleSprite(sprite), cost);
+    }
+    return sprite;
+}
+
+void InstAnalog::renderDynamic(QPainter* painter)
+{
+    mNeedle.layer.draw(painter, mNeedle.origin);
 }
 
-void InstAnalog::drawTrianglePointer(QPainter* painter)
+void InstAnalog::updateTrianglePointer()
 {
     qint16 endPointX = -mAngleSin * cArrowLen + mCenterX;
     qint16 endPointY = mAngleCos * cArrowLen + mCenterY;
@@ -260,12 +355,8 @@ void InstAnalog::drawTrianglePointer(QPainter* painter)
     qint16 rightPointX = mAngleCos * cArrowWidth + mCenterX;
     qint16 rightPointY = mAngleSin * cArrowWidth + mCenterY;
 
-    const QPointF points[3] = {
-        QPointF(endPointX + cOffsetX, endPointY + cOffsetY),
-        QPointF(leftPointX + cOffsetX, leftPointY + cOffsetY),
-        QPointF(rightPointX + cOffsetX, rightPointY + cOffsetY)
-    };
-
-    painter->drawPolygon(points, 3);
-
+    mPointer.resize(3);
+    mPointer[0] = QPointF(endPointX + cOffsetX, endPointY + cOffsetY);
+    mPointer[1] = QPointF(leftPointX + cOffsetX, leftPointY + cOffsetY);
+    mPointer[2] = QPointF(rightPointX + cOffsetX, rightPointY + cOffsetY);
 }
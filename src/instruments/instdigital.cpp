@@ -6,7 +6,7 @@ const QString InstDigital::TAG_NAME = "DIGITAL";
 
 bool InstDigital::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     InstDigital::loadProperties();
     return VisuInstrument::refresh(key);
 }
@@ -15,11 +15,11 @@ void InstDigital::loadProperties()
 {
     VisuInstrument::loadProperties();
 
-    GET_PROPERTY(cShowSignalName, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cShowSignalUnit, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cPadding, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cLeadingDigits, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cDecimalDigits, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cShowSignalName, mProperties);
+    GET_PROPERTY(cShowSignalUnit, mProperties);
+    GET_PROPERTY(cPadding, mProperties);
+    GET_PROPERTY(cLeadingDigits, mProperties);
+    GET_PROPERTY(cDecimalDigits, mProperties);
 
     mTagName = InstDigital::TAG_NAME;
 }
@@ -29,11 +29,13 @@ void InstDigital::renderStatic(QPainter* painter)
     clear(painter);
 }
 
-void InstDigital::renderDynamic(QPainter* painter)
+bool InstDigital::prepareStatic()
 {
-    setFont(painter);
-    setPen(painter, cColorForeground);
+    return true;
+}
 
+QString InstDigital::formatText()
+{
     QString text =  QString::number(mSignal->getRealValue(), 'f', cDecimalDigits).rightJustified(cLeadingDigits, '0');
 
     if (cShowSignalName) {
@@ -44,5 +46,28 @@ void InstDigital::renderDynamic(QPainter* painter)
         text += " " + mSignal->getUnit();
     }
 
-    painter->drawText(cPadding, cHeight - cPadding, text);
+    return text;
+}
+
+/**
+ * @brief InstDigital::getVisualKey
+ * Text is all that is drawn, so it is compared with the displayed one.
+ */
+bool InstDigital::getVisualKey(quint64& key)
+{
+    QString text = formatText();
+    if (text != mText)
+    {
+        mText = text;
+        ++mTextVersion;
+    }
+    key = mTextVersion;
+    return true;
+}
+
+void InstDigital::renderDynamic(QPainter* painter)
+{
+    setFont(painter);
+    setPen(painter, cColorForeground);
+    painter->drawText(cPadding, cHeight - cPadding, mText);
 }
@@ -5,7 +5,7 @@ const QString InstLED::TAG_NAME = "LED";
 
 bool InstLED::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     InstLED::loadProperties();
     return VisuInstrument::refresh(key);
 }
@@ -14,15 +14,15 @@ void InstLED::loadProperties()
 {
     VisuInstrument::loadProperties();
 
-    GET_PROPERTY(cRadius, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cVal1, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cVal2, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cCondition, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorOn, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorOff, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cImageOn, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cImageOff, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cShowSignalName, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cRadius, mProperties);
+    GET_PROPERTY(cVal1, mProperties);
+    GET_PROPERTY(cVal2, mProperties);
+    GET_PROPERTY(cCondition, mProperties);
+    GET_PROPERTY(cColorOn, mProperties);
+    GET_PROPERTY(cColorOff, mProperties);
+    GET_PROPERTY(cImageOn, mProperties);
+    GET_PROPERTY(cImageOff, mProperties);
+    GET_PROPERTY(cShowSignalName, mProperties);
 
     mTagName = InstLED::TAG_NAME;
 }
@@ -31,8 +31,6 @@ void InstLED::renderStatic(QPainter *painter)
 {
     clear(painter);
 
-    cCenterH = (cHeight - cRadius) / 2;
-
     if (cShowSignalName)
     {
         setPen(painter, cColorStatic);
@@ -43,9 +41,8 @@ void InstLED::renderStatic(QPainter *painter)
 
 }
 
-void InstLED::renderDynamic(QPainter *painter)
+bool InstLED::isConditionOn()
 {
-    setPen(painter, cColorStatic);
     double value = mSignal->getRealValue();
     bool conditionOn = false;
 
@@ -58,19 +55,49 @@ void InstLED::renderDynamic(QPainter *painter)
         case LedCondition::MORE_THAN:     conditionOn = value > cVal1; break;
     }
 
-    int imageId = conditionOn ? cImageOn : cImageOff;
+    return conditionOn;
+}
+
+bool InstLED::prepareStatic()
+{
+    cCenterH = (cHeight - cRadius) / 2;
+    return true;
+}
+
+bool InstLED::getVisualKey(quint64& key)
+{
+    mConditionOn = isConditionOn();
+    key = mConditionOn;
+    return true;
+}
+
+QRect InstLED::prepareDynamic()
+{
+    mImage = nullptr;
+
+    int imageId = mConditionOn ? cImageOn : cImageOff;
     if (imageId >= 0)
     {
         VisuWidget* imageWidget = VisuConfiguration::get()->getWidget(imageId);
-        StaticImage* image;
-        if ( (image = qobject_cast<StaticImage*>(imageWidget)) != nullptr)
-        {
-            painter->drawImage(0, 0, image->getImage());
-        }
+        mImage = qobject_cast<StaticImage*>(imageWidget);
+        return mImage != nullptr ? QRect(QPoint(0, 0), mImage->getImage().size()) : QRect();
+    }
+
+    // widened by outline
+    return QRect(2, cCenterH, cRadius, cRadius).adjusted(-2, -2, 2, 2);
+}
+
+void InstLED::renderDynamic(QPainter *painter)
+{
+    setPen(painter, cColorStatic);
+
+    if (mImage != nullptr)
+    {
+        painter->drawImage(0, 0, mImage->getImage());
     }
-    else
+    else if ((mConditionOn ? cImageOn : cImageOff) < 0)
     {
-        setBrush(painter, conditionOn ? cColorOn : cColorOff);
+        setBrush(painter, mConditionOn ? cColorOn : cColorOff);
         QRect rect(2, cCenterH, cRadius, cRadius);
         painter->drawEllipse(rect);
     }
@@ -5,7 +5,7 @@ const QString InstLinear::KEY_HORIZONTAL = "horizontal";
 
 bool InstLinear::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     InstLinear::loadProperties();
     return InstLinear::refresh(key);
 }
@@ -14,13 +14,13 @@ void InstLinear::loadProperties()
 {
     VisuInstrument::loadProperties();
 
-    GET_PROPERTY(cLineThickness, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorLen, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMinorLen, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorCnt, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMinorCnt, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cBarThickness, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cHorizontal, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cLineThickness, mProperties);
+    GET_PROPERTY(cMajorLen, mProperties);
+    GET_PROPERTY(cMinorLen, mProperties);
+    GET_PROPERTY(cMajorCnt, mProperties);
+    GET_PROPERTY(cMinorCnt, mProperties);
+    GET_PROPERTY(cBarThickness, mProperties);
+    GET_PROPERTY(cHorizontal, mProperties);
 
     mTagName = InstLinear::TAG_NAME;
 }
@@ -84,14 +84,11 @@ void InstLinear::renderDivisions(QPainter* painter)
 
         ofs += delta;
     }
-
-
-    mBarLength = ofs - delta - mMargin;
 }
 
-void InstLinear::setupMargin(QPainter* painter)
+void InstLinear::setupMargin()
 {
-    QFontMetrics fontMetrics = painter->fontMetrics();
+    QFontMetrics fontMetrics(getFont(), mPixmapStatic.device());
 
     if (cHorizontal)
     {
@@ -111,7 +108,6 @@ void InstLinear::renderStatic(QPainter *painter)
 
     setPen(painter, cColorStatic, cLineThickness);
     setFont(painter);
-    setupMargin(painter);
     renderDivisions(painter);
 
     if (cHorizontal)
@@ -125,20 +121,45 @@ void InstLinear::renderStatic(QPainter *painter)
 
 }
 
-void InstLinear::renderDynamic(QPainter *painter)
+bool InstLinear::prepareStatic()
 {
-    setPen(painter, cColorStatic);
-    setBrush(painter, cColorForeground);
+    setupMargin();
+
+    quint16 total = cMajorCnt * cMinorCnt;
+    int directionDimension = cHorizontal ? cWidth : cHeight;
+    double delta = (double)(directionDimension - 2 * mMargin) / total;
+    mBarLength = delta * total;
+    return true;
+}
 
-    double ofs = mSignal->getNormalizedValue() * mBarLength;
+bool InstLinear::getVisualKey(quint64& key)
+{
+    mBarValue = mSignal->getNormalizedValue() * mBarLength;
+    key = mBarValue;
+    return true;
+}
+
+QRect InstLinear::prepareDynamic()
+{
+    int ofs = mBarValue;
     if (cHorizontal)
     {
-        painter->drawRect(mMargin, SPACING, ofs, cBarThickness);
+        mBar = QRect(mMargin, SPACING, ofs, cBarThickness);
     }
     else
     {
-        painter->drawRect(SPACING, cHeight - mMargin, cBarThickness, -ofs);
+        mBar = QRect(SPACING, cHeight - mMargin, cBarThickness, -ofs);
     }
+
+    // widened by outline
+    return mBar.normalized().adjusted(-2, -2, 2, 2);
+}
+
+void InstLinear::renderDynamic(QPainter *painter)
+{
+    setPen(painter, cColorStatic);
+    setBrush(painter, cColorForeground);
+    painter->drawRect(mBar);
 }
 
 bool InstLinear::refresh(const QString& key)
@@ -148,7 +169,7 @@ bool InstLinear::refresh(const QString& key)
     {
         // update dimensions as well
         std::swap(cWidth, cHeight);
-        std::swap(mProperties[KEY_WIDTH], mProperties[KEY_HEIGHT]);
+        mProperties.swap(KEY_WIDTH, KEY_HEIGHT);
         setup();
         changed = true;
     }
@@ -1,11 +1,12 @@
 #include "insttimeplot.h"
 #include "visumisc.h"
+#include <QtMath>
 
 const QString InstTimePlot::TAG_NAME = "TIME_PLOT";
 
 bool InstTimePlot::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     InstTimePlot::loadProperties();
     return VisuInstrument::refresh(key);
 }
@@ -14,18 +15,19 @@ void InstTimePlot::loadProperties()
 {
     VisuInstrument::loadProperties();
 
-    GET_PROPERTY(cLineThickness, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cStaticThickness, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMarkerThickness, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorCnt, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMinorCnt, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cTicksInSecond, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cTimespan, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMarkerDt, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cDecimals, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cDivisionFormat, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMasterTimeFormat, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorGraphBackground, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cLineThickness, mProperties);
+    GET_PROPERTY(cStaticThickness, mProperties);
+    GET_PROPERTY(cMarkerThickness, mProperties);
+    GET_PROPERTY(cMajorCnt, mProperties);
+    GET_PROPERTY(cMinorCnt, mProperties);
+    GET_PROPERTY(cTicksInSecond, mProperties);
+    GET_PROPERTY(cTimespan, mProperties);
+    GET_PROPERTY(cMarkerDt, mProperties);
+    GET_PROPERTY(cScroll, mProperties);
+    GET_PROPERTY(cDecimals, mProperties);
+    GET_PROPERTY(cDivisionFormat, mProperties);
+    GET_PROPERTY(cMasterTimeFormat, mProperties);
+    GET_PROPERTY(cColorGraphBackground, mProperties);
 
     mTagName = InstTimePlot::TAG_NAME;
 }
@@ -51,10 +53,18 @@ void InstTimePlot::init(QPainter* painter)
     mPlotEndY = mMargin;
     mPlotRangeX = mPlotEndX - mPlotStartX;
     mPlotRangeY = mPlotStartY - mPlotEndY;
+    mTimestampRect = QRect(mPlotStartX, 0, cWidth - mPlotStartX, mPlotEndY);
 
     mLastUpdateX = mPlotStartX;
     mLastUpdateY = mPlotStartY;
     mLastMarkerTime = 0;
+    mLastUpdateTime = mSignal->getTimestamp();
+    mLastSequence = mSignal->getHistory().appended();
+    mRebuildGraph = true;
+
+    mColumnSize = 0;
+    mGraphPath.resize(0);
+    mGraphPath.append(QPointF(mLastUpdateX, mLastUpdateY));
 }
 
 quint16 InstTimePlot::getLabelMaxWidth(QPainter* painter)
@@ -116,11 +126,15 @@ void InstTimePlot::renderLabelsAndMajors(QPainter* painter)
 void InstTimePlot::setupGraphObjects()
 {
     delete mGraphPainter;
-    mGraphPixmap = QPixmap(cWidth, cHeight);
+    mGraphPixmap = createLayer(cWidth, cHeight);
     mGraphPixmap.fill(Qt::transparent);
     setAttribute(Qt::WA_TranslucentBackground);
-    mGraphPainter = new QPainter(&mGraphPixmap);
+    mGraphPainter = new QPainter(mGraphPixmap.device());
     mGraphPainter->setRenderHint(QPainter::Antialiasing);
+    if (cScroll)
+    {
+        mGraphPainter->setClipRect(getScrollRect());
+    }
 }
 
 void InstTimePlot::renderGraphAreaBackground(QPainter* painter)
@@ -177,10 +191,14 @@ void InstTimePlot::renderMarker(QPainter* painter, quint64 timestamp)
         painter->drawLine(markerX, mPlotStartY, markerX, mPlotEndY);
 
         setFont(mGraphPainter);
+        QString label = getDisplayTime(timestamp, cDivisionFormat);
         painter->drawText(markerX,
                             cHeight,
-                            getDisplayTime(timestamp, cDivisionFormat));
+                            label);
         mLastMarkerTime = timestamp;
+
+        int labelWidth = mGraphPainter->fontMetrics().width(label);
+        mGraphDirty |= QRect(markerX - cMarkerThickness - 1, 0, labelWidth + 2 * cMarkerThickness + 2, cHeight);
     }
 }
 
@@ -199,18 +217,140 @@ void InstTimePlot::renderTimeLabel(QPainter* painter)
                       "Time " + getDisplayTime(timestamp, cMasterTimeFormat));
 }
 
-void InstTimePlot::renderGraphSegment(QPainter* painter)
+/**
+ * @brief InstTimePlot::addGraphPoint
+ * Adds point to the current pixel column. Only first, last, minimal and
+ * maximal point of a column are kept, so number of drawn segments is
+ * bounded by plot width, no matter how many samples arrive.
+ */
+void InstTimePlot::addGraphPoint(const QPointF& point)
+{
+    int column = (int)point.x();
+    if (mColumnSize > 0 && column != mColumn)
+    {
+        flushGraphColumn();
+    }
+
+    if (mColumnSize == 0)
+    {
+        mColumn = column;
+        mColumnFirst = point;
+        mColumnMin = point;
+        mColumnMax = point;
+        mColumnMinOrder = 0;
+        mColumnMaxOrder = 0;
+    }
+    else if (point.y() < mColumnMin.y())
+    {
+        mColumnMin = point;
+        mColumnMinOrder = mColumnSize;
+    }
+    else if (point.y() > mColumnMax.y())
+    {
+        mColumnMax = point;
+        mColumnMaxOrder = mColumnSize;
+    }
+
+    mColumnLast = point;
+    ++mColumnSize;
+}
+
+void InstTimePlot::appendColumnExtreme(const QPointF& point, int order)
+{
+    // first and last point are appended anyway
+    if (order > 0 && order < mColumnSize - 1)
+    {
+        mGraphPath.append(point);
+    }
+}
+
+/**
+ * @brief InstTimePlot::flushGraphColumn
+ * Moves reduced column to graph path, keeping order of arrival.
+ */
+void InstTimePlot::flushGraphColumn()
+{
+    if (mColumnSize == 0)
+    {
+        return;
+    }
+
+    mGraphPath.append(mColumnFirst);
+    if (mColumnMinOrder < mColumnMaxOrder)
+    {
+        appendColumnExtreme(mColumnMin, mColumnMinOrder);
+        appendColumnExtreme(mColumnMax, mColumnMaxOrder);
+    }
+    else
+    {
+        appendColumnExtreme(mColumnMax, mColumnMaxOrder);
+        appendColumnExtreme(mColumnMin, mColumnMinOrder);
+    }
+    if (mColumnSize > 1)
+    {
+        mGraphPath.append(mColumnLast);
+    }
+
+    mColumnSize = 0;
+}
+
+/**
+ * @brief InstTimePlot::drawGraphPath
+ * Draws pending points to graph pixmap with a single call. Points are
+ * drawn as separate segments rather than polyline, which would join them,
+ * so every segment gets the caps it got when drawn with its own drawLine.
+ * Last point is kept as the start of the next path.
+ */
+void InstTimePlot::drawGraphPath()
 {
+    flushGraphColumn();
+    if (mGraphPath.size() < 2)
+    {
+        return;
+    }
+
+    mGraphSegments.resize(0);
+    for (int i = 1; i < mGraphPath.size(); ++i)
+    {
+        mGraphSegments.append(mGraphPath[i - 1]);
+        mGraphSegments.append(mGraphPath[i]);
+    }
+
     setPen(mGraphPainter, cColorForeground, cLineThickness);
-    mGraphPainter->drawLine(mLastUpdateX, mLastUpdateY, mNewUpdateX, mNewUpdateY);
-    painter->drawPixmap(0, 0, mGraphPixmap);
+    mGraphPainter->drawLines(mGraphSegments.constData(), mGraphSegments.size() / 2);
+
+    // widened by line thickness and antialiasing
+    int margin = cLineThickness + 1;
+    mGraphDirty |= QPolygonF(mGraphPath).boundingRect().toAlignedRect().adjusted(-margin, -margin, margin, margin);
+
+    QPointF last = mGraphPath.last();
+    mGraphPath.resize(0);
+    mGraphPath.append(last);
+}
+
+void InstTimePlot::renderGraphSegment(QPainter* painter)
+{
+    mGraphPixmap.draw(painter, QPoint(0, 0));
+}
+
+void InstTimePlot::clearGraph(const QRect& rect)
+{
+    mGraphPainter->setCompositionMode(QPainter::CompositionMode_Clear);
+    mGraphPainter->fillRect(rect, Qt::transparent);
+    mGraphPainter->setCompositionMode(QPainter::CompositionMode_SourceOver);
+    mGraphDirty |= rect;
 }
 
 void InstTimePlot::resetPlotToStart()
 {
-    mGraphPixmap.fill(Qt::transparent);
+    // pending points would be cleared right away, so they are dropped
+    mColumnSize = 0;
+    clearGraph(mGraphPixmap.rect());
     mNewUpdateX = mPlotStartX + (mNewUpdateX - mLastUpdateX);
     mLastUpdateX = mPlotStartX;
+
+    mGraphPath.resize(0);
+    mGraphPath.append(QPointF(mLastUpdateX, mLastUpdateY));
 }
 
 bool InstTimePlot::noSpaceLeftOnRight()
@@ -218,9 +358,8 @@ bool InstTimePlot::noSpaceLeftOnRight()
     return (mNewUpdateX > mPlotEndX);
 }
 
-void InstTimePlot::calculateNewGraphPoint(quint64 timestamp)
+void InstTimePlot::calculateNewGraphPoint(quint64 timestamp, double value)
 {
-    double value = mSignal->getNormalizedValue();
     quint64 dt = timestamp > mLastUpdateTime ? (timestamp - mLastUpdateTime) : 0;
     double dx = (double)mPlotRangeX * dt / (cTimespan);
 
@@ -235,10 +374,9 @@ void InstTimePlot::updateLastValues(quint64 timestamp)
     mLastUpdateTime = timestamp;
 }
 
-void InstTimePlot::renderDynamic(QPainter* painter)
+void InstTimePlot::renderSample(quint64 timestamp, double value)
 {
-    quint64 timestamp = mSignal->getTimestamp();
-    calculateNewGraphPoint(timestamp);
+    calculateNewGraphPoint(timestamp, value);
 
     if (noSpaceLeftOnRight())
     {
@@ -247,11 +385,209 @@ void InstTimePlot::renderDynamic(QPainter* painter)
 
     if (shouldRenderMarker(timestamp))
     {
+        drawGraphPath();    // keep graph drawn before the marker below it
         renderMarker(mGraphPainter, timestamp);
     }
-    renderTimeLabel(painter);
-    renderGraphSegment(painter);
 
+    addGraphPoint(QPointF(mNewUpdateX, mNewUpdateY));
+    updateLastValues(timestamp);
+}
+
+/**
+ * @brief InstTimePlot::renderSweeping
+ * Plots every sample received since last render, not only the latest
+ * value, so coalesced updates do not leave gaps in the graph. Graph is
+ * wiped when it reaches the right edge.
+ */
+void InstTimePlot::renderSweeping()
+{
+    const VisuSignalHistory& history = mSignal->getHistory();
+    VisuSignalHistory::Range samples = history.since(mLastSequence);
+    mLastSequence = history.appended();
+
+    if (samples.size() == 0)
+    {
+        renderSample(mSignal->getTimestamp(), mSignal->getNormalizedValue());
+    }
+
+    for (int i = 0; i < samples.size(); ++i)
+    {
+        double value = mSignal->rawToReal(samples.rawValueAt(i));
+        renderSample(samples.timestampAt(i), mSignal->normalize(value));
+    }
+}
+
+QRect InstTimePlot::getScrollRect()
+{
+    // marker labels are below the plot, so whole height is scrolled
+    return QRect(mPlotStartX, 0, cWidth - mPlotStartX, cHeight);
+}
+
+double InstTimePlot::getScrollX(quint64 timestamp)
+{
+    return mPlotEndX - (mScrollTime - timestamp) * mPlotRangeX / cTimespan;
+}
+
+void InstTimePlot::renderScrollMarkers(quint64 from, quint64 to)
+{
+    for (quint64 markerTime = from - (from % cMarkerDt) + cMarkerDt;
+         markerTime <= to;
+         markerTime += cMarkerDt)
+    {
+        drawGraphPath();    // keep graph drawn before the marker below it
+
+        double markerX = getScrollX(markerTime);
+        setPen(mGraphPainter, cColorStatic, cMarkerThickness);
+        mGraphPainter->drawLine(markerX, mPlotStartY, markerX, mPlotEndY);
+
+        // label is left of the marker, so it does not reach the area
+        // that is cleared on next scroll
+        setFont(mGraphPainter);
+        QString label = getDisplayTime(markerTime, cDivisionFormat);
+        int labelWidth = mGraphPainter->fontMetrics().width(label);
+        mGraphPainter->drawText(markerX - labelWidth, cHeight, label);
+        mGraphDirty |= QRect(markerX - labelWidth - 1, 0, labelWidth + cMarkerThickness + 2, cHeight);
+    }
+}
+
+void InstTimePlot::renderScrollSample(quint64 timestamp, double value)
+{
+    renderScrollMarkers(mLastUpdateTime, timestamp);
+
+    mNewUpdateX = getScrollX(timestamp);
+    mNewUpdateY = mPlotStartY - mPlotRangeY * value;
+
+    addGraphPoint(QPointF(mNewUpdateX, mNewUpdateY));
     updateLastValues(timestamp);
 }
 
+/**
+ * @brief InstTimePlot::rebuildGraph
+ * Redraws whole visible window from signal history, ending at given
+ * timestamp. Used after graph objects are recreated and when new data
+ * moves the window by more than its width.
+ */
+void InstTimePlot::rebuildGraph(quint64 timestamp)
+{
+    clearGraph(mGraphPixmap.rect());
+    mGraphPath.resize(0);
+    mColumnSize = 0;
+
+    quint64 from = timestamp > cTimespan ? timestamp - cTimespan : 0;
+    mScrollTime = timestamp;
+    mLastUpdateTime = from;
+
+    VisuSignalHistory::Range samples = mSignal->getHistory().window(from, timestamp);
+    if (samples.size() == 0)
+    {
+        renderScrollSample(mSignal->getTimestamp(), mSignal->getNormalizedValue());
+    }
+
+    for (int i = 0; i < samples.size(); ++i)
+    {
+        double value = mSignal->rawToReal(samples.rawValueAt(i));
+        renderScrollSample(samples.timestampAt(i), mSignal->normalize(value));
+    }
+
+    mRebuildGraph = false;
+}
+
+/**
+ * @brief InstTimePlot::scrollGraph
+ * Shifts already drawn graph left by whole pixels, so that given timestamp
+ * fits to the right edge, and clears the strip that was uncovered.
+ */
+void InstTimePlot::scrollGraph(quint64 timestamp)
+{
+    int shift = qCeil((timestamp - mScrollTime) * mPlotRangeX / cTimespan);
+    if (shift <= 0)
+    {
+        return;
+    }
+
+    drawGraphPath();
+
+    // layer can not be scrolled while painter is active on it
+    QRect scrollRect = getScrollRect();
+    mGraphPainter->end();
+    mGraphPixmap.scroll(-shift, 0, scrollRect);
+    mGraphPainter->begin(mGraphPixmap.device());
+    mGraphPainter->setRenderHint(QPainter::Antialiasing);
+    mGraphPainter->setClipRect(scrollRect);
+    mGraphDirty |= scrollRect;
+
+    // keep the last drawn point, new segment starts there
+    int stripX = mPlotEndX - shift + 1;
+    clearGraph(QRect(stripX, 0, cWidth - stripX, cHeight));
+
+    mScrollTime += (double)shift * cTimespan / mPlotRangeX;
+    if (!mGraphPath.isEmpty())
+    {
+        mGraphPath.first().rx() -= shift;
+    }
+}
+
+/**
+ * @brief InstTimePlot::renderScrolling
+ * Newest sample is always at the right edge. Only the strip uncovered by
+ * scrolling is rasterized, unless the whole window has to be rebuilt.
+ */
+void InstTimePlot::renderScrolling()
+{
+    const VisuSignalHistory& history = mSignal->getHistory();
+    VisuSignalHistory::Range samples = history.since(mLastSequence);
+    mLastSequence = history.appended();
+
+    quint64 timestamp = samples.size() > 0 ? samples.timestampAt(samples.size() - 1)
+                                           : mSignal->getTimestamp();
+
+    if (mRebuildGraph
+            || timestamp < mLastUpdateTime
+            || (timestamp - mScrollTime) >= cTimespan)
+    {
+        rebuildGraph(timestamp);
+        return;
+    }
+
+    scrollGraph(timestamp);
+
+    if (history.capacity() == 0)
+    {
+        renderScrollSample(timestamp, mSignal->getNormalizedValue());
+    }
+
+    for (int i = 0; i < samples.size(); ++i)
+    {
+        double value = mSignal->rawToReal(samples.rawValueAt(i));
+        renderScrollSample(samples.timestampAt(i), mSignal->normalize(value));
+    }
+}
+
+/**
+ * @brief InstTimePlot::prepareDynamic
+ * Plots new samples to graph pixmap, keeping track of area they changed.
+ * Time label changes on every render as well.
+ */
+QRect InstTimePlot::prepareDynamic()
+{
+    mGraphDirty = QRect();
+
+    if (cScroll)
+    {
+        renderScrolling();
+    }
+    else
+    {
+        renderSweeping();
+    }
+    drawGraphPath();
+
+    return mGraphDirty | mTimestampRect;
+}
+
+void InstTimePlot::renderDynamic(QPainter* painter)
+{
+    renderTimeLabel(painter);
+    renderGraphSegment(painter);
+}
+
@@ -4,7 +4,7 @@ const QString InstXYPlot::TAG_NAME = "XY_PLOT";
 
 bool InstXYPlot::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     InstXYPlot::loadProperties();
     return VisuInstrument::refresh(key);
 }
@@ -13,16 +13,16 @@ void InstXYPlot::loadProperties()
 {
     VisuInstrument::loadProperties();
 
-    GET_PROPERTY(cSignalIdY, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cBallSize, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorCntX, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorCntY, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorLenX, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMajorLenY, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cPadding, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cDecimals, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cReverseX, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cReverseY, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cSignalIdY, mProperties);
+    GET_PROPERTY(cBallSize, mProperties);
+    GET_PROPERTY(cMajorCntX, mProperties);
+    GET_PROPERTY(cMajorCntY, mProperties);
+    GET_PROPERTY(cMajorLenX, mProperties);
+    GET_PROPERTY(cMajorLenY, mProperties);
+    GET_PROPERTY(cPadding, mProperties);
+    GET_PROPERTY(cDecimals, mProperties);
+    GET_PROPERTY(cReverseX, mProperties);
+    GET_PROPERTY(cReverseY, mProperties);
 
     mTagName = InstXYPlot::TAG_NAME;
 }
@@ -81,7 +81,11 @@ void InstXYPlot::renderBall(QPainter* painter)
 {
     setPen(painter, cColorStatic);
     setBrush(painter, cColorForeground);
+    painter->drawEllipse(mBall);
+}
 
+void InstXYPlot::updateBall()
+{
     int x = mLastValX * (cWidth - 2 * cPadding) + cPadding - cBallSize / 2;
     int y = mLastValY * (cHeight - 2 * cPadding) + cPadding - cBallSize / 2;
 
@@ -95,8 +99,7 @@ void InstXYPlot::renderBall(QPainter* painter)
         y = cHeight - cBallSize - y;
     }
 
-    QRect rect(x, y, cBallSize, cBallSize);
-    painter->drawEllipse(rect);
+    mBall = QRect(x, y, cBallSize, cBallSize);
 }
 
 void InstXYPlot::renderStatic(QPainter *painter)
@@ -105,27 +108,49 @@ void InstXYPlot::renderStatic(QPainter *painter)
     setPen(painter, cColorStatic);
     clear(painter);
 
-    mCenterX = cWidth / 2;
-    mCenterY = cHeight / 2;
-
     painter->drawLine(cPadding, mCenterY, cWidth - cPadding, mCenterY);
     painter->drawLine(mCenterX, cPadding, mCenterX, cHeight - cPadding);
 
     renderAxis(painter);
 }
 
-void InstXYPlot::renderDynamic(QPainter *painter)
+bool InstXYPlot::prepareStatic()
+{
+    mCenterX = cWidth / 2;
+    mCenterY = cHeight / 2;
+    return true;
+}
+
+bool InstXYPlot::getVisualKey(quint64& key)
 {
-    if (mSignal->getId() == cSignalId)
+    // Updates of both signals may be coalesced into single render,
+    // so both values are always taken from connected signals.
+    mSignalX = connectedSignals.value(SIGNAL_FIRST);
+    mSignalY = connectedSignals.value(SIGNAL_SECOND);
+
+    if (mSignalX != nullptr)
     {
-        mLastValX = mSignal->getNormalizedValue();   // primary signal shown on X axis
-        mSignalX = mSignal;
+        mLastValX = mSignalX->getNormalizedValue();   // primary signal shown on X axis
     }
-    else
+
+    if (mSignalY != nullptr)
     {
-        mLastValY = mSignal->getNormalizedValue();   // additional signal shown on Y axis
-        mSignalY = mSignal;
+        mLastValY = mSignalY->getNormalizedValue();   // additional signal shown on Y axis
     }
 
+    updateBall();
+
+    key = ((quint64)(quint32)mBall.x() << 32) | (quint32)mBall.y();
+    return true;
+}
+
+QRect InstXYPlot::prepareDynamic()
+{
+    // widened by outline
+    return mBall.adjusted(-2, -2, 2, 2);
+}
+
+void InstXYPlot::renderDynamic(QPainter *painter)
+{
     renderBall(painter);
 }
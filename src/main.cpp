@@ -4,9 +4,12 @@
 #include "visuappinfo.h"
 #include "visuserver.h"
 #include "visuapplication.h"
+#include "visuconfigloader.h"
+#include "visucompiledconfig.h"
 #include "exceptions/configloadexception.h"
 
 #define DEFAULT_CONFIG "configs/default.xml"
+#define COMPILE_OPTION "--compile"
 
 void showMessageBox(QString message)
 {
@@ -20,13 +23,31 @@ int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
     VisuAppInfo::setCLIArgs(argc, argv);
+    VisuConfigLoader::loadMetaCache(VisuConfigLoader::META_CACHE_PATH);
     try
     {
-        if (argc == 1)
+        if (argc > 1 && QString(argv[1]) == COMPILE_OPTION)
+        {
+            // visualization --compile <config.xml> <output>
+            if (argc != 4)
+            {
+                qDebug("Usage: %s %s <config.xml> <output>", argv[0], COMPILE_OPTION);
+                return 1;
+            }
+            VisuCompiledConfig::compile(argv[2], argv[3]);
+            return 0;
+        }
+        else if (argc == 1)
         {
             VisuAppInfo::setInEditorMode(true);
             new MainWindow();
         }
+        else if (VisuAppInfo::argsSize() <= (int)VisuAppInfo::CLI_Args::CONFIG_PATH)
+        {
+            // only options were given, e.g. visualization --replay <log>
+            qDebug("Usage: %s <config> [options]", argv[0]);
+            return 1;
+        }
         else
         {
             QString configPath = VisuAppInfo::getCLIArg(VisuAppInfo::CLI_Args::CONFIG_PATH);
@@ -46,5 +67,8 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // meta of all types used by loaded configuration is known by now
+    VisuConfigLoader::saveMetaCache(VisuConfigLoader::META_CACHE_PATH);
+
     return a.exec();
 }
@@ -368,7 +368,7 @@ void MainWindow::openImageAdder()
                 properties[VisuWidget::KEY_NAME] = QFileInfo(imagePath).fileName();
 
                 QMap<QString, VisuPropertyMeta> metaProperties =
-                        VisuConfigLoader::getMetaMapFromFile(StaticImage::TAG_NAME, VisuWidget::TAG_NAME);
+                        VisuConfigLoader::getMetaMap(StaticImage::TAG_NAME, VisuWidget::TAG_NAME);
 
                 StaticImage* image = new StaticImage(mStage, properties, metaProperties);
                 setActiveWidget(image);
@@ -519,6 +519,11 @@ void MainWindow::addSignal(QPointer<VisuSignal> signal, bool isNewSignal)
     {
         mConfiguration->addSignal(signal);
     }
+    else
+    {
+        // factor and offset might have changed
+        mConfiguration->rebuildSignalDispatch();
+    }
 
     updateMenuSignalList();
 }
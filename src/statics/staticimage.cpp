@@ -11,7 +11,7 @@ const QString StaticImage::KEY_IMAGE = "image";
 
 bool StaticImage::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     StaticImage::loadProperties();
     return StaticImage::refresh(key);
 }
@@ -19,9 +19,9 @@ bool StaticImage::updateProperties(const QString& key, const QString& value)
 void StaticImage::loadProperties()
 {
     VisuWidget::loadProperties();
-    GET_PROPERTY(cImage, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cShow, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cResize, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cImage, mProperties);
+    GET_PROPERTY(cShow, mProperties);
+    GET_PROPERTY(cResize, mProperties);
 }
 
 void StaticImage::paintEvent(QPaintEvent* event)
@@ -61,3 +61,14 @@ QImage StaticImage::getImage()
 {
     return cImage;
 }
+
+/**
+ * @brief StaticImage::setImage
+ * Sets already decoded image, used when loading compiled configuration.
+ * @param image
+ */
+void StaticImage::setImage(const QImage& image)
+{
+    cImage = image;
+    update();
+}
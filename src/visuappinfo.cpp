@@ -2,6 +2,9 @@
 
 VisuAppInfo* VisuAppInfo::instance = nullptr;
 
+// options that take no value, so they never consume following argument
+const QStringList VisuAppInfo::CLI_FLAGS = { "trace-overlay" };
+
 VisuAppInfo* VisuAppInfo::getInstance()
 {
     if (instance == nullptr)
@@ -55,15 +58,53 @@ const QString& VisuAppInfo::getCLIArg(CLI_Args arg)
     return getInstance()->cliArgs[(int)arg];
 }
 
+/**
+ * @brief VisuAppInfo::setCLIArgs
+ * Stores positional arguments, in order of CLI_Args. Options of form
+ * "--name value" or "--name=value", and flags listed in CLI_FLAGS, may
+ * appear anywhere and are stored separately, so they do not shift
+ * positional arguments.
+ */
 void VisuAppInfo::setCLIArgs(int argc, char* argv[])
 {
     QStringList& args = getInstance()->cliArgs;
+    QMap<QString, QString>& options = getInstance()->cliOptions;
     for (int i=0 ; i<argc ; ++i)
     {
-        args.append(QString(argv[i]));
+        QString arg(argv[i]);
+        if (i > 0 && arg.startsWith("--"))
+        {
+            QString name = arg.mid(2);
+            QString value;
+            int separator = name.indexOf('=');
+            if (separator >= 0)
+            {
+                value = name.mid(separator + 1);
+                name.truncate(separator);
+            }
+            else if (!CLI_FLAGS.contains(name) && i + 1 < argc && !QString(argv[i + 1]).startsWith("--"))
+            {
+                value = QString(argv[++i]);
+            }
+            options.insert(name, value);
+        }
+        else
+        {
+            args.append(arg);
+        }
     }
 }
 
+bool VisuAppInfo::hasCLIOption(const QString& name)
+{
+    return getInstance()->cliOptions.contains(name);
+}
+
+QString VisuAppInfo::getCLIOption(const QString& name, const QString& defaultValue)
+{
+    return getInstance()->cliOptions.value(name, defaultValue);
+}
+
 void VisuAppInfo::setServer(VisuServer *srv)
 {
     getInstance()->server = srv;
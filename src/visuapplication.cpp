@@ -2,21 +2,71 @@
 #include "exceptions/configloadexception.h"
 #include "visuconfigloader.h"
 #include "visumisc.h"
+#include "visulatencytracer.h"
+#include "visulatencyoverlay.h"
 #include <QPainter>
 #include <QFile>
+#include <QCoreApplication>
+
+#define TRACE_OPTION "trace"
+#define TRACE_OVERLAY_OPTION "trace-overlay"
 
 VisuApplication::VisuApplication(QString path)
 {
     mConfiguration = VisuConfiguration::get();
     loadConfiguration(path);
     setupWindow();
+    setupTracing();
     mServer = new VisuServer();
 }
 
+/**
+ * @brief VisuApplication::setupTracing
+ * Enables latency tracing, if requested by "--trace <file.json>" or
+ * "--trace-overlay". Summary is printed and trace file written on exit.
+ */
+void VisuApplication::setupTracing()
+{
+    bool overlay = VisuAppInfo::hasCLIOption(TRACE_OVERLAY_OPTION);
+    if (!overlay && !VisuAppInfo::hasCLIOption(TRACE_OPTION))
+    {
+        return;
+    }
+
+    VisuLatencyTracer::get()->enable();
+
+    if (overlay)
+    {
+        VisuLatencyOverlay* latencyOverlay = new VisuLatencyOverlay(this);
+        latencyOverlay->move(0, 0);
+        latencyOverlay->raise();
+    }
+
+    QString tracePath = VisuAppInfo::getCLIOption(TRACE_OPTION);
+    QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, [tracePath]()
+    {
+        qDebug("Latency from packet arrival to paint:\n%s",
+               VisuLatencyTracer::get()->getSummary().toStdString().c_str());
+
+        if (!tracePath.isEmpty() && !VisuLatencyTracer::get()->writeChromeTrace(tracePath))
+        {
+            qDebug("Failed to write trace to %s.", tracePath.toStdString().c_str());
+        }
+    });
+}
+
 void VisuApplication::loadConfiguration(QString path)
 {
-    QByteArray xml = VisuConfigLoader::loadXMLFromFile(path);
-    mConfiguration->fromXML(this, QString(xml));
+    if (VisuCompiledConfig::isCompiled(path))
+    {
+        mCompiledConfig.open(path);
+        mConfiguration->fromCompiled(this, mCompiledConfig);
+    }
+    else
+    {
+        QByteArray xml = VisuConfigLoader::loadXMLFromFile(path);
+        mConfiguration->fromXML(this, QString(xml));
+    }
 }
 
 void VisuApplication::setupWindow()
@@ -26,7 +76,18 @@ void VisuApplication::setupWindow()
     VisuMisc::setBackgroundColor(this, mConfiguration->getBackgroundColor());
 }
 
+/**
+ * @brief VisuApplication::run
+ * Starts server. It is stopped on exit, which flushes and closes record
+ * and stops ingest thread.
+ */
 void VisuApplication::run()
 {
     mServer->start();
+
+    VisuServer* server = mServer;
+    QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, [server]()
+    {
+        server->stop();
+    });
 }
@@ -0,0 +1,252 @@
+#include "visubulkudpsocket.h"
+
+#ifdef Q_OS_LINUX
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+// control buffer of every message holds single SO_RXQ_OVFL counter
+#ifdef Q_OS_LINUX
+#define CONTROL_SIZE CMSG_SPACE(sizeof(quint32))
+#endif
+
+VisuBulkUdpSocket::VisuBulkUdpSocket(int batchSize, QObject* parent) : QObject(parent),
+                                                                     mFd(-1),
+                                                                     mBatchSize(qMax(batchSize, 1)),
+                                                                     mNotifier(nullptr),
+                                                                     mKernelDrops(0)
+{
+}
+
+VisuBulkUdpSocket::~VisuBulkUdpSocket()
+{
+    close();
+}
+
+bool VisuBulkUdpSocket::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief VisuBulkUdpSocket::bind
+ * Opens non-blocking socket bound to IPv4 address and port and allocates
+ * receive slab.
+ * @param address
+ * @param port
+ * @param receiveBufferSize SO_RCVBUF in bytes, 0 keeps system default
+ * @return true if socket is ready to receive
+ */
+bool VisuBulkUdpSocket::bind(const QHostAddress& address, quint16 port, int receiveBufferSize)
+{
+#ifdef Q_OS_LINUX
+    close();
+
+    mFd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (mFd < 0)
+    {
+        qDebug("Failed to create UDP socket: %s", strerror(errno));
+        return false;
+    }
+
+    if (receiveBufferSize > 0)
+    {
+        // SO_RCVBUFFORCE may exceed rmem_max, but needs CAP_NET_ADMIN
+        if (setsockopt(mFd, SOL_SOCKET, SO_RCVBUFFORCE, &receiveBufferSize, sizeof(receiveBufferSize)) != 0
+            && setsockopt(mFd, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize)) != 0)
+        {
+            qDebug("Failed to set UDP receive buffer to %d bytes: %s", receiveBufferSize, strerror(errno));
+        }
+    }
+
+    int enable = 1;
+    if (setsockopt(mFd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) != 0)
+    {
+        qDebug("Kernel drop counter not available: %s", strerror(errno));
+    }
+
+    sockaddr_in socketAddress;
+    memset(&socketAddress, 0, sizeof(socketAddress));
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_port = htons(port);
+    socketAddress.sin_addr.s_addr = htonl(address.toIPv4Address());
+    if (::bind(mFd, (sockaddr*)&socketAddress, sizeof(socketAddress)) != 0)
+    {
+        qDebug("Failed to bind UDP port %d: %s", port, strerror(errno));
+        close();
+        return false;
+    }
+
+    mSlab.reset(new quint8[(size_t)mBatchSize * MAX_DATAGRAM_SIZE]);
+    mMessages.resize(mBatchSize);
+    mVectors.resize(mBatchSize);
+    mAddresses.resize(mBatchSize);
+    mControl.resize(mBatchSize * CONTROL_SIZE);
+
+    mNotifier = new QSocketNotifier(mFd, QSocketNotifier::Read, this);
+    QObject::connect(mNotifier, SIGNAL(activated(int)), this, SIGNAL(readyRead()));
+
+    qDebug("UDP bulk receive of %d datagrams, receive buffer %d bytes.", mBatchSize, getReceiveBufferSize());
+    return true;
+#else
+    (void)address;
+    (void)port;
+    (void)receiveBufferSize;
+    return false;
+#endif
+}
+
+void VisuBulkUdpSocket::close()
+{
+    delete mNotifier;
+    mNotifier = nullptr;
+
+#ifdef Q_OS_LINUX
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+    }
+#endif
+    mFd = -1;
+}
+
+/**
+ * @brief VisuBulkUdpSocket::receive
+ * Reads pending datagrams, at most batch size of them, with single
+ * syscall. Datagrams stay valid until next call.
+ * @return number of datagrams read, 0 if none was pending
+ */
+int VisuBulkUdpSocket::receive()
+{
+#ifdef Q_OS_LINUX
+    if (mFd < 0)
+    {
+        return 0;
+    }
+
+    // kernel overwrites lengths, so headers are set up again on each call
+    for (int i = 0; i < mBatchSize; ++i)
+    {
+        mVectors[i].iov_base = mSlab.get() + (size_t)i * MAX_DATAGRAM_SIZE;
+        mVectors[i].iov_len = MAX_DATAGRAM_SIZE;
+
+        msghdr& header = mMessages[i].msg_hdr;
+        memset(&header, 0, sizeof(header));
+        header.msg_iov = &mVectors[i];
+        header.msg_iovlen = 1;
+        header.msg_name = &mAddresses[i];
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_control = mControl.data() + i * CONTROL_SIZE;
+        header.msg_controllen = CONTROL_SIZE;
+        mMessages[i].msg_len = 0;
+    }
+
+    int count = recvmmsg(mFd, mMessages.data(), mBatchSize, MSG_DONTWAIT, nullptr);
+    if (count < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            qDebug("UDP receive failed: %s", strerror(errno));
+        }
+        return 0;
+    }
+
+    // counter is cumulative, last message carries the latest value
+    for (int i = count - 1; i >= 0; --i)
+    {
+        msghdr& header = mMessages[i].msg_hdr;
+        cmsghdr* control = CMSG_FIRSTHDR(&header);
+        if (control != nullptr && control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL)
+        {
+            quint32 drops;
+            memcpy(&drops, CMSG_DATA(control), sizeof(drops));
+            mKernelDrops.store(drops, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    return count;
+#else
+    return 0;
+#endif
+}
+
+const quint8* VisuBulkUdpSocket::datagramData(int index) const
+{
+    return mSlab.get() + (size_t)index * MAX_DATAGRAM_SIZE;
+}
+
+qint64 VisuBulkUdpSocket::datagramSize(int index) const
+{
+#ifdef Q_OS_LINUX
+    return mMessages[index].msg_len;
+#else
+    (void)index;
+    return 0;
+#endif
+}
+
+/**
+ * @brief VisuBulkUdpSocket::datagramSource
+ * Sender of datagram, IPv4 address in upper and port in lower 16 bits.
+ */
+quint64 VisuBulkUdpSocket::datagramSource(int index) const
+{
+#ifdef Q_OS_LINUX
+    const sockaddr_in& address = mAddresses[index];
+    return ((quint64)ntohl(address.sin_addr.s_addr) << 16) | ntohs(address.sin_port);
+#else
+    (void)index;
+    return 0;
+#endif
+}
+
+bool VisuBulkUdpSocket::isTruncated(int index) const
+{
+#ifdef Q_OS_LINUX
+    return (mMessages[index].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+#else
+    (void)index;
+    return false;
+#endif
+}
+
+int VisuBulkUdpSocket::getBatchSize() const
+{
+    return mBatchSize;
+}
+
+/**
+ * @brief VisuBulkUdpSocket::getReceiveBufferSize
+ * Returns effective receive buffer size, as reported by the kernel.
+ */
+int VisuBulkUdpSocket::getReceiveBufferSize() const
+{
+#ifdef Q_OS_LINUX
+    int size = 0;
+    socklen_t length = sizeof(size);
+    if (mFd >= 0)
+    {
+        getsockopt(mFd, SOL_SOCKET, SO_RCVBUF, &size, &length);
+    }
+    return size;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief VisuBulkUdpSocket::getKernelDrops
+ * Datagrams dropped by the kernel since socket was bound. Safe to call
+ * from any thread.
+ */
+quint64 VisuBulkUdpSocket::getKernelDrops() const
+{
+    return mKernelDrops.load(std::memory_order_relaxed);
+}
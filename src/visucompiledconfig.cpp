@@ -0,0 +1,323 @@
+#include "visucompiledconfig.h"
+
+#include <QHash>
+#include <QVector>
+#include <cstring>
+#include "visuconfigloader.h"
+#include "visumisc.h"
+#include "exceptions/configloadexception.h"
+#include "statics/staticimage.h"
+
+namespace
+{
+    template <typename T>
+    void appendRaw(QByteArray& out, const T* data, int count)
+    {
+        out.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+    }
+
+    void alignTo(QByteArray& out, int alignment)
+    {
+        while (out.size() % alignment != 0)
+        {
+            out.append('\0');
+        }
+    }
+}
+
+VisuCompiledConfig::VisuCompiledConfig() : mData(nullptr), mSize(0), mHeader(nullptr)
+{
+}
+
+VisuCompiledConfig::~VisuCompiledConfig()
+{
+    if (mData != nullptr)
+    {
+        mFile.unmap(const_cast<uchar*>(mData));
+    }
+}
+
+/**
+ * @brief VisuCompiledConfig::isCompiled
+ * Checks whether file at path starts with compiled configuration magic.
+ * @param path
+ * @return
+ */
+bool VisuCompiledConfig::isCompiled(const QString& path)
+{
+    QFile file(path);
+    quint32 magic = 0;
+    return file.open(QFile::ReadOnly)
+            && file.read(reinterpret_cast<char*>(&magic), sizeof(magic)) == sizeof(magic)
+            && magic == MAGIC;
+}
+
+/**
+ * @brief VisuCompiledConfig::compile
+ * Parses XML configuration and writes its compiled form. Images of static
+ * image widgets are decoded once here and their property is left empty.
+ * @param xmlPath
+ * @param outputPath
+ */
+void VisuCompiledConfig::compile(const QString& xmlPath, const QString& outputPath)
+{
+    QByteArray xml = VisuConfigLoader::loadXMLFromFile(xmlPath);
+    VisuConfiguration::Elements elements = VisuConfiguration::parseXML(QString(xml));
+
+    QHash<QString, quint32> stringIds;
+    QVector<StringEntry> strings;
+    QVector<ushort> pool;
+    QVector<ElementEntry> elementEntries;
+    QVector<PropertyEntry> properties;
+    QVector<ImageEntry> imageEntries;
+    QVector<QImage> images;
+
+    auto intern = [&](const QString& str) -> quint32
+    {
+        auto itr = stringIds.constFind(str);
+        if (itr != stringIds.constEnd())
+        {
+            return itr.value();
+        }
+
+        StringEntry entry = { (quint32)pool.size(), (quint32)str.size() };
+        for (const QChar& c : str)
+        {
+            pool.append(c.unicode());
+        }
+        quint32 id = strings.size();
+        strings.append(entry);
+        stringIds.insert(str, id);
+        return id;
+    };
+
+    auto addElement = [&](ElementKind kind, const QMap<QString, QString>& map)
+    {
+        ElementEntry entry = { kind, (quint32)properties.size(), (quint32)map.size() };
+        elementEntries.append(entry);
+        for (auto itr = map.constBegin(); itr != map.constEnd(); ++itr)
+        {
+            PropertyEntry property = { intern(itr.key()), intern(itr.value()) };
+            properties.append(property);
+        }
+    };
+
+    if (!elements.configurationProperties.isEmpty())
+    {
+        addElement(ELEMENT_CONFIGURATION, elements.configurationProperties);
+    }
+    for (const QMap<QString, QString>& signal : elements.signalsProperties)
+    {
+        addElement(ELEMENT_SIGNAL, signal);
+    }
+    for (int i = 0; i < elements.widgetsProperties.size(); ++i)
+    {
+        QMap<QString, QString> widget = elements.widgetsProperties[i];
+        if (widget.value(VisuWidget::KEY_TYPE) == StaticImage::TAG_NAME)
+        {
+            QImage image = VisuMisc::strToImage(widget.value(StaticImage::KEY_IMAGE),
+                                                widget.value(StaticImage::KEY_FORMAT));
+            if (!image.isNull())
+            {
+                image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+                ImageEntry entry = { (quint32)i,
+                                     (quint32)image.width(),
+                                     (quint32)image.height(),
+                                     (quint32)image.bytesPerLine(),
+                                     0,
+                                     (quint32)image.byteCount() };
+                imageEntries.append(entry);
+                images.append(image);
+                widget[StaticImage::KEY_IMAGE] = QString();
+            }
+        }
+        addElement(ELEMENT_WIDGET, widget);
+    }
+
+    Header header = {};
+    header.magic = MAGIC;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.version = VERSION;
+    header.stringCount = strings.size();
+    header.elementCount = elementEntries.size();
+    header.propertyCount = properties.size();
+    header.imageCount = imageEntries.size();
+
+    QByteArray out(sizeof(Header), '\0');
+    header.stringsOffset = out.size();
+    appendRaw(out, strings.constData(), strings.size());
+    header.poolOffset = out.size();
+    header.poolSize = pool.size() * sizeof(ushort);
+    appendRaw(out, pool.constData(), pool.size());
+    alignTo(out, sizeof(quint32));
+    header.elementsOffset = out.size();
+    appendRaw(out, elementEntries.constData(), elementEntries.size());
+    header.propertiesOffset = out.size();
+    appendRaw(out, properties.constData(), properties.size());
+
+    // image table is written after pixel offsets are known
+    header.imagesOffset = out.size();
+    out.append(QByteArray(imageEntries.size() * sizeof(ImageEntry), '\0'));
+    for (int i = 0; i < images.size(); ++i)
+    {
+        alignTo(out, IMAGE_ALIGNMENT);
+        imageEntries[i].offset = out.size();
+        out.append(reinterpret_cast<const char*>(images[i].constBits()), imageEntries[i].size);
+    }
+    memcpy(out.data() + header.imagesOffset, imageEntries.constData(), imageEntries.size() * sizeof(ImageEntry));
+    memcpy(out.data(), &header, sizeof(Header));
+
+    QFile file(outputPath);
+    if (!file.open(QFile::WriteOnly) || file.write(out) != out.size())
+    {
+        throw ConfigLoadException("Error writing compiled config to file %1", outputPath);
+    }
+}
+
+/**
+ * @brief VisuCompiledConfig::open
+ * Maps compiled configuration into memory and validates its tables.
+ * Mapping is kept until this object is destroyed.
+ * @param path
+ */
+void VisuCompiledConfig::open(const QString& path)
+{
+    mFile.setFileName(path);
+    if (!mFile.open(QFile::ReadOnly))
+    {
+        throw ConfigLoadException("Error loading config from file %1", path);
+    }
+
+    mSize = mFile.size();
+    mData = mFile.map(0, mSize);
+    if (mData == nullptr || mSize < (qint64)sizeof(Header))
+    {
+        throw ConfigLoadException("Error mapping compiled config %1", path);
+    }
+
+    mHeader = reinterpret_cast<const Header*>(mData);
+    if (mHeader->magic != MAGIC || mHeader->byteOrder != BYTE_ORDER_MARK || mHeader->version != VERSION)
+    {
+        throw ConfigLoadException("Compiled config %1 was made by other version or on other platform, compile it again", path);
+    }
+
+    if (table<StringEntry>(mHeader->stringsOffset, mHeader->stringCount) == nullptr
+        || table<ushort>(mHeader->poolOffset, mHeader->poolSize / sizeof(ushort)) == nullptr
+        || table<ElementEntry>(mHeader->elementsOffset, mHeader->elementCount) == nullptr
+        || table<PropertyEntry>(mHeader->propertiesOffset, mHeader->propertyCount) == nullptr
+        || table<ImageEntry>(mHeader->imagesOffset, mHeader->imageCount) == nullptr)
+    {
+        throw ConfigLoadException("Compiled config %1 is corrupted", path);
+    }
+}
+
+/**
+ * @brief VisuCompiledConfig::table
+ * Returns pointer to table in mapped file, or nullptr if table does not
+ * fit the file or is not aligned.
+ */
+template <typename T>
+const T* VisuCompiledConfig::table(quint32 offset, quint32 count) const
+{
+    if (offset % alignof(T) != 0 || (quint64)offset + (quint64)count * sizeof(T) > (quint64)mSize)
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(mData + offset);
+}
+
+/**
+ * @brief VisuCompiledConfig::getElements
+ * Builds properties of all elements. Every pooled string is copied out of
+ * the mapping once and shared by all maps using it.
+ * @return
+ */
+VisuConfiguration::Elements VisuCompiledConfig::getElements() const
+{
+    const StringEntry* stringEntries = table<StringEntry>(mHeader->stringsOffset, mHeader->stringCount);
+    const QChar* pool = reinterpret_cast<const QChar*>(mData + mHeader->poolOffset);
+    const quint32 poolLength = mHeader->poolSize / sizeof(ushort);
+
+    QVector<QString> strings(mHeader->stringCount);
+    for (quint32 i = 0; i < mHeader->stringCount; ++i)
+    {
+        const StringEntry& entry = stringEntries[i];
+        if ((quint64)entry.offset + entry.length > poolLength)
+        {
+            throw ConfigLoadException("Compiled config string %1 out of range", QString::number(i));
+        }
+        strings[i] = QString(pool + entry.offset, entry.length);
+    }
+
+    const ElementEntry* elementEntries = table<ElementEntry>(mHeader->elementsOffset, mHeader->elementCount);
+    const PropertyEntry* properties = table<PropertyEntry>(mHeader->propertiesOffset, mHeader->propertyCount);
+
+    VisuConfiguration::Elements elements;
+    for (quint32 i = 0; i < mHeader->elementCount; ++i)
+    {
+        const ElementEntry& entry = elementEntries[i];
+        if ((quint64)entry.firstProperty + entry.propertyCount > mHeader->propertyCount)
+        {
+            throw ConfigLoadException("Compiled config element %1 out of range", QString::number(i));
+        }
+
+        // properties are stored in key order, so each one goes to the end
+        QMap<QString, QString> map;
+        for (quint32 p = entry.firstProperty; p < entry.firstProperty + entry.propertyCount; ++p)
+        {
+            if (properties[p].key >= mHeader->stringCount || properties[p].value >= mHeader->stringCount)
+            {
+                throw ConfigLoadException("Compiled config property %1 out of range", QString::number(p));
+            }
+            map.insert(map.constEnd(), strings[properties[p].key], strings[properties[p].value]);
+        }
+
+        switch (entry.kind)
+        {
+            case ELEMENT_CONFIGURATION:
+                elements.configurationProperties = map;
+                break;
+            case ELEMENT_SIGNAL:
+                elements.signalsProperties.append(map);
+                break;
+            case ELEMENT_WIDGET:
+                elements.widgetsProperties.append(map);
+                break;
+            default:
+                throw ConfigLoadException("Unknown compiled config element kind %1", QString::number(entry.kind));
+        }
+    }
+
+    return elements;
+}
+
+/**
+ * @brief VisuCompiledConfig::getImages
+ * Returns images of static image widgets, keyed by widget index. Images
+ * use pixels in the mapping directly and are valid while it is kept.
+ * @return
+ */
+QMap<int, QImage> VisuCompiledConfig::getImages() const
+{
+    const ImageEntry* imageEntries = table<ImageEntry>(mHeader->imagesOffset, mHeader->imageCount);
+
+    QMap<int, QImage> images;
+    for (quint32 i = 0; i < mHeader->imageCount; ++i)
+    {
+        const ImageEntry& entry = imageEntries[i];
+        if ((quint64)entry.offset + entry.size > (quint64)mSize
+            || entry.bytesPerLine < entry.width * sizeof(quint32)
+            || (quint64)entry.bytesPerLine * entry.height > entry.size)
+        {
+            throw ConfigLoadException("Compiled config image %1 out of range", QString::number(i));
+        }
+
+        images.insert(entry.widget, QImage(mData + entry.offset,
+                                           entry.width,
+                                           entry.height,
+                                           entry.bytesPerLine,
+                                           QImage::Format_ARGB32_Premultiplied));
+    }
+
+    return images;
+}
@@ -2,9 +2,16 @@
 #include <QFile>
 #include "exceptions/configloadexception.h"
 #include <QXmlStreamAttribute>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
 #include "visuappinfo.h"
 
 const QString VisuConfigLoader::PATH = "system/";
+const QString VisuConfigLoader::META_CACHE_PATH = "system/meta.cache";
+
+QMap<QString, VisuConfigLoader::MetaEntry> VisuConfigLoader::metaRegistry;
+bool VisuConfigLoader::metaRegistryChanged = false;
 
 QByteArray VisuConfigLoader::loadXMLFromFile(QString path)
 {
@@ -71,6 +78,10 @@ QMap<QString, VisuPropertyMeta> VisuConfigLoader::parseMetaToMap(QXmlStreamReade
                 {
                     meta.description = attr.value().toString();
                 }
+                else if (metaKey == VisuPropertyMeta::KEY_OPTIONAL)
+                {
+                    meta.optional = attr.value().toString() == "true";
+                }
             }
         }
         else if (xmlReader.tokenType() == QXmlStreamReader::Characters && !xmlReader.isWhitespace())
@@ -132,8 +143,128 @@ QMap<QString, QString> VisuConfigLoader::getMapFromFile(QString type, QString ta
 
 QMap<QString, VisuPropertyMeta> VisuConfigLoader::getMetaMapFromFile(QString type, QString tag)
 {
-    QString path = PATH + type + ".xml";
+    QString path = getSourcePath(type);
     QString xmlString = VisuConfigLoader::loadXMLFromFile(path);
     QXmlStreamReader xmlReader(xmlString);
     return VisuConfigLoader::parseMetaToMap(xmlReader, tag);
 }
+
+QString VisuConfigLoader::getSourcePath(const QString& type)
+{
+    return PATH + type + ".xml";
+}
+
+/**
+ * @brief VisuConfigLoader::getMetaMap
+ * Returns meta of given type. Meta file is parsed only on the first
+ * request, afterwards all instances share the same, immutable map.
+ * @param type
+ * @param tag
+ * @return
+ */
+const QMap<QString, VisuPropertyMeta>& VisuConfigLoader::getMetaMap(const QString& type, const QString& tag)
+{
+    auto itr = metaRegistry.find(type);
+    if (itr == metaRegistry.end())
+    {
+        MetaEntry entry;
+        entry.meta = getMetaMapFromFile(type, tag);
+
+        QFileInfo source(getSourcePath(type));
+        entry.sourceSize = source.size();
+        entry.sourceModified = source.lastModified().toMSecsSinceEpoch();
+
+        itr = metaRegistry.insert(type, entry);
+        metaRegistryChanged = true;
+    }
+    return itr.value().meta;
+}
+
+/**
+ * @brief VisuConfigLoader::loadMetaCache
+ * Preloads meta registry from binary cache written by saveMetaCache.
+ * Entries whose meta file changed since are skipped and parsed again
+ * when requested.
+ * @param path
+ * @return true if cache was read and all entries were up to date
+ */
+bool VisuConfigLoader::loadMetaCache(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic;
+    quint16 version;
+    stream >> magic >> version;
+    if (magic != META_CACHE_MAGIC || version != META_CACHE_VERSION)
+    {
+        return false;
+    }
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 count;
+    stream >> count;
+
+    bool upToDate = true;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        QString type;
+        MetaEntry entry;
+        stream >> type >> entry.sourceSize >> entry.sourceModified >> entry.meta;
+
+        QFileInfo source(getSourcePath(type));
+        if (source.size() != entry.sourceSize ||
+            source.lastModified().toMSecsSinceEpoch() != entry.sourceModified)
+        {
+            upToDate = false;
+            continue;
+        }
+
+        if (!metaRegistry.contains(type))
+        {
+            metaRegistry.insert(type, entry);
+        }
+    }
+
+    return upToDate && stream.status() == QDataStream::Ok;
+}
+
+/**
+ * @brief VisuConfigLoader::saveMetaCache
+ * Writes meta registry to binary cache, if some meta file was parsed
+ * since the cache was loaded.
+ * @param path
+ */
+void VisuConfigLoader::saveMetaCache(const QString& path)
+{
+    if (!metaRegistryChanged)
+    {
+        return;
+    }
+
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly))
+    {
+        qDebug("Meta cache %s can not be written.", qPrintable(path));
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << META_CACHE_MAGIC << META_CACHE_VERSION;
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << (quint32)metaRegistry.size();
+
+    for (auto itr = metaRegistry.constBegin(); itr != metaRegistry.constEnd(); ++itr)
+    {
+        stream << itr.key()
+               << itr.value().sourceSize
+               << itr.value().sourceModified
+               << itr.value().meta;
+    }
+
+    metaRegistryChanged = false;
+}
@@ -8,6 +8,7 @@
 #include "visusignal.h"
 #include "visupropertyloader.h"
 #include "visuconfigloader.h"
+#include "visucompiledconfig.h"
 #include "visumisc.h"
 #include "exceptions/configloadexception.h"
 #include "instruments/instanalog.h"
@@ -56,24 +57,34 @@ VisuConfiguration::~VisuConfiguration()
     }
 }
 
-void VisuConfiguration::createSignalFromToken(QXmlStreamReader& xmlReader)
+void VisuConfiguration::createSignal(const QMap<QString, QString>& properties)
 {
-    QMap<QString, QString> properties = VisuConfigLoader::parseToMap(xmlReader, VisuSignal::TAG_NAME);
     VisuSignal* signal = new VisuSignal(properties);
     signalsList.push_back(signal);
 }
 
-QPointer<VisuWidget> VisuConfiguration::createWidgetFromToken(QXmlStreamReader& xmlReader, QWidget *parent)
+QPointer<VisuWidget> VisuConfiguration::createWidget(const QMap<QString, QString>& properties, QWidget *parent)
 {
-    QMap<QString, QString> properties = VisuConfigLoader::parseToMap(xmlReader, VisuWidget::TAG_NAME);
-    VisuWidget* widget = VisuWidgetFactory::createWidget(parent,
-                                                         properties);
+    VisuWidget* widget = VisuWidgetFactory::constructWidget(parent,
+                                                            properties);
     addWidget(widget);
     widget->show();
 
     return widget;
 }
 
+void VisuConfiguration::finishPhase(LoadPhase phase, QElapsedTimer& timer)
+{
+    mLoadProfile.elapsedNs[phase] = timer.nsecsElapsed();
+    mLoadProfile.peakMemoryKb[phase] = VisuMisc::getPeakMemoryKb();
+    timer.restart();
+}
+
+const VisuConfiguration::LoadProfile& VisuConfiguration::getLoadProfile() const
+{
+    return mLoadProfile;
+}
+
 void VisuConfiguration::initializeInstruments()
 {
     for (int i=0; i<signalsList.size(); i++) {
@@ -81,26 +92,27 @@ void VisuConfiguration::initializeInstruments()
     }
 }
 
-void VisuConfiguration::createConfigurationFromToken(QXmlStreamReader& xmlReader)
+void VisuConfiguration::createConfiguration(const QMap<QString, QString>& properties)
 {
-    mProperties = VisuConfigLoader::parseToMap(xmlReader, TAG_NAME);
+    mProperties = properties;
     setConfigValues();
 }
 
 void VisuConfiguration::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     setConfigValues();
 }
 
-QMap<QString, QString>& VisuConfiguration::getProperties()
+const QMap<QString, QString>& VisuConfiguration::getProperties() const
 {
-    return mProperties;
+    return mProperties.map();
 }
 
 void VisuConfiguration::setPropertiesMeta(QMap<QString, VisuPropertyMeta> meta)
 {
     mPropertiesMeta = meta;
+    mProperties.setSchema(VisuPropertySchema::compile(VisuConfiguration::TAG_NAME, mPropertiesMeta));
 }
 
 
@@ -111,26 +123,40 @@ QMap<QString, VisuPropertyMeta> VisuConfiguration::getPropertiesMeta()
 
 void VisuConfiguration::setConfigValues()
 {
-    GET_PROPERTY(cPort, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cWidth, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cHeight, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorBackground, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cName, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cConectivity, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cSerialPort, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cBaudRate, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cSerialBindToSignal, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cSerialRegex, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cSerialStartEnable, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cSerialStart, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cPullMessageEnable, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cPullMessage, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cPullPeriod, mProperties, mPropertiesMeta);
-}
-
-void VisuConfiguration::fromXML(QWidget *parent, const QString& xmlString)
+    GET_PROPERTY(cPort, mProperties);
+    GET_PROPERTY(cWidth, mProperties);
+    GET_PROPERTY(cHeight, mProperties);
+    GET_PROPERTY(cColorBackground, mProperties);
+    GET_PROPERTY(cRenderFps, mProperties);
+    GET_PROPERTY(cRasterLayers, mProperties);
+    GET_PROPERTY(cName, mProperties);
+    GET_PROPERTY(cConectivity, mProperties);
+    GET_PROPERTY(cSerialPort, mProperties);
+    GET_PROPERTY(cBaudRate, mProperties);
+    GET_PROPERTY(cSerialProtocol, mProperties);
+    GET_PROPERTY(cSerialBindToSignal, mProperties);
+    GET_PROPERTY(cSerialRegex, mProperties);
+    GET_PROPERTY(cSerialStartEnable, mProperties);
+    GET_PROPERTY(cSerialStart, mProperties);
+    GET_PROPERTY(cPullMessageEnable, mProperties);
+    GET_PROPERTY(cPullMessage, mProperties);
+    GET_PROPERTY(cPullPeriod, mProperties);
+    GET_PROPERTY(cUdpBulkReceive, mProperties);
+    GET_PROPERTY(cUdpBatchSize, mProperties);
+    GET_PROPERTY(cUdpReceiveBuffer, mProperties);
+    GET_PROPERTY(cDropStaleSamples, mProperties);
+}
+
+/**
+ * @brief VisuConfiguration::parseXML
+ * Tokenizes configuration document into properties of its elements.
+ * @param xmlString
+ * @return
+ */
+VisuConfiguration::Elements VisuConfiguration::parseXML(const QString& xmlString)
 {
     QXmlStreamReader xmlReader(xmlString);
+    Elements elements;
 
     while (xmlReader.tokenType() != QXmlStreamReader::EndDocument
            && xmlReader.tokenType() != QXmlStreamReader::Invalid) {
@@ -140,13 +166,13 @@ void VisuConfiguration::fromXML(QWidget *parent, const QString& xmlString)
             ConfigLoadException::setContext("loading configuration");
 
             if (xmlReader.name() == VisuSignal::TAG_NAME) {
-                createSignalFromToken(xmlReader);
+                elements.signalsProperties.append(VisuConfigLoader::parseToMap(xmlReader, VisuSignal::TAG_NAME));
             }
             else if (xmlReader.name() == VisuWidget::TAG_NAME) {
-                createWidgetFromToken(xmlReader, parent);
+                elements.widgetsProperties.append(VisuConfigLoader::parseToMap(xmlReader, VisuWidget::TAG_NAME));
             }
             else if (xmlReader.name() == TAG_NAME) {
-                createConfigurationFromToken(xmlReader);
+                elements.configurationProperties = VisuConfigLoader::parseToMap(xmlReader, TAG_NAME);
             }
             else if (xmlReader.name() == TAG_VISU_CONFIG) {
                 // No actions needed.
@@ -167,20 +193,137 @@ void VisuConfiguration::fromXML(QWidget *parent, const QString& xmlString)
 
     }
 
+    return elements;
+}
+
+/**
+ * @brief VisuConfiguration::fromXML
+ * Loads configuration in phases: whole document is tokenized first, then
+ * meta of used types is loaded, elements are constructed, instruments are
+ * wired to signals and finally rendered. Duration of every phase is kept
+ * in load profile.
+ * @param parent
+ * @param xmlString
+ */
+void VisuConfiguration::fromXML(QWidget *parent, const QString& xmlString)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Elements elements = parseXML(xmlString);
+    finishPhase(PHASE_TOKENIZE, timer);
+
+    fromElements(parent, elements, timer);
+}
+
+/**
+ * @brief VisuConfiguration::fromCompiled
+ * Loads configuration from compiled file. Tokenize phase only copies
+ * strings out of the mapped file, images are used as stored, without
+ * base64 decoding. Compiled file has to stay open while configuration
+ * is used, as images reference its memory.
+ * @param parent
+ * @param compiled
+ */
+void VisuConfiguration::fromCompiled(QWidget *parent, const VisuCompiledConfig& compiled)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Elements elements = compiled.getElements();
+    finishPhase(PHASE_TOKENIZE, timer);
+
+    fromElements(parent, elements, timer);
+
+    // widgets are created in order on clean configuration, so their ids
+    // match indices of compiled widget elements
+    QMap<int, QImage> images = compiled.getImages();
+    for (auto itr = images.constBegin(); itr != images.constEnd(); ++itr)
+    {
+        StaticImage* image = qobject_cast<StaticImage*>(getWidget(itr.key()));
+        if (image != nullptr)
+        {
+            image->setImage(itr.value());
+        }
+    }
+}
+
+void VisuConfiguration::fromElements(QWidget *parent, const Elements& elements, QElapsedTimer& timer)
+{
+    ConfigLoadException::setContext("loading configuration");
+    VisuConfigLoader::getMetaMap(VisuSignal::TAG_NAME, VisuSignal::TAG_NAME);
+    for (const QMap<QString, QString>& properties : elements.widgetsProperties)
+    {
+        VisuConfigLoader::getMetaMap(properties.value(VisuWidget::KEY_TYPE), VisuWidget::TAG_NAME);
+    }
+    finishPhase(PHASE_META, timer);
+
+    if (!elements.configurationProperties.isEmpty())
+    {
+        createConfiguration(elements.configurationProperties);
+    }
+    for (const QMap<QString, QString>& properties : elements.signalsProperties)
+    {
+        createSignal(properties);
+    }
+    rebuildSignalDispatch();
+    for (const QMap<QString, QString>& properties : elements.widgetsProperties)
+    {
+        createWidget(properties, parent);
+    }
+    finishPhase(PHASE_CONSTRUCT, timer);
+
+    for (VisuWidget* widget : widgetsList)
+    {
+        VisuInstrument* instrument = qobject_cast<VisuInstrument*>(widget);
+        if (instrument != nullptr)
+        {
+            instrument->connectSignals();
+        }
+    }
+    finishPhase(PHASE_WIRING, timer);
+
     initializeInstruments();
+    finishPhase(PHASE_RENDER, timer);
 }
 
 QPointer<VisuSignal> VisuConfiguration::getSignal(quint16 signalId)
 {
-    if(signalId >= signalsList.size())
+    const VisuSignalDispatch::Entry* entry = mSignalDispatch->find(signalId);
+    if (entry == nullptr)
     {
         // We shouldn't throw unhandled exception here, as that would
         // mean that signal source can crash application if wrong
         // signal id is sent.
-        qDebug("Signal id %d too large!", signalId);
+        qDebug("Unknown signal id %d!", signalId);
         return nullptr;
     }
-    return signalsList[signalId];
+    return entry->signal;
+}
+
+/**
+ * @brief VisuConfiguration::getSignalDispatch
+ * Returns current signal dispatch table. Safe to call from any thread,
+ * returned table stays valid after it is replaced by rebuild.
+ * @return
+ */
+QSharedPointer<const VisuSignalDispatch> VisuConfiguration::getSignalDispatch() const
+{
+    QMutexLocker locker(&mSignalDispatchMutex);
+    return mSignalDispatch;
+}
+
+/**
+ * @brief VisuConfiguration::rebuildSignalDispatch
+ * Builds dispatch table from current signals. Has to be called in GUI
+ * thread whenever signal is added, deleted or its properties change.
+ */
+void VisuConfiguration::rebuildSignalDispatch()
+{
+    QSharedPointer<const VisuSignalDispatch> dispatch(new VisuSignalDispatch(signalsList));
+
+    QMutexLocker locker(&mSignalDispatchMutex);
+    mSignalDispatch = dispatch;
 }
 
 QPointer<VisuInstrument> VisuConfiguration::getInstrument(quint16 instrument_id)
@@ -208,6 +351,11 @@ quint32 VisuConfiguration::getBaudRate()
     return cBaudRate;
 }
 
+quint8 VisuConfiguration::getSerialProtocol()
+{
+    return cSerialProtocol;
+}
+
 quint16 VisuConfiguration::getWidth()
 {
     return cWidth;
@@ -223,6 +371,16 @@ QColor VisuConfiguration::getBackgroundColor()
     return cColorBackground;
 }
 
+quint16 VisuConfiguration::getRenderFps()
+{
+    return cRenderFps;
+}
+
+bool VisuConfiguration::isRasterLayers()
+{
+    return cRasterLayers;
+}
+
 QSize VisuConfiguration::getSize() const
 {
     return QSize(cWidth, cHeight);
@@ -273,6 +431,26 @@ quint32 VisuConfiguration::getSerialPullPeriod()
     return cPullPeriod;
 }
 
+bool VisuConfiguration::isUdpBulkReceive()
+{
+    return cUdpBulkReceive;
+}
+
+quint16 VisuConfiguration::getUdpBatchSize()
+{
+    return cUdpBatchSize;
+}
+
+quint32 VisuConfiguration::getUdpReceiveBuffer()
+{
+    return cUdpReceiveBuffer;
+}
+
+bool VisuConfiguration::isDropStaleSamples()
+{
+    return cDropStaleSamples;
+}
+
 QVector<QPointer<VisuWidget> > VisuConfiguration::getWidgets()
 {
     return widgetsList;
@@ -343,9 +521,18 @@ void VisuConfiguration::deleteWidget(QPointer<VisuWidget> widget)
 
 void VisuConfiguration::addSignal(QPointer<VisuSignal> signal)
 {
-    int signalId = getFreeId((QVector<QPointer<QObject>>&)signalsList);
+    int index = getFreeId((QVector<QPointer<QObject>>&)signalsList);
+
+    // loaded signals may use sparse ids, which need not match their index
+    quint16 signalId = index;
+    while (mSignalDispatch->find(signalId) != nullptr)
+    {
+        ++signalId;
+    }
+
     signal->setId(signalId);
-    signalsList[signalId] = signal;
+    signalsList[index] = signal;
+    rebuildSignalDispatch();
 }
 
 int VisuConfiguration::getFreeId(QVector<QPointer<QObject>> &list)
@@ -369,7 +556,8 @@ void VisuConfiguration::deleteSignal(QPointer<VisuSignal> signal)
 void VisuConfiguration::deleteSignal(int signalId)
 {
     // pointer will be cleared automaticaly by QPointer
-    delete (signalsList[signalId]);
+    delete (getSignal(signalId));
+    rebuildSignalDispatch();
 }
 
 template <typename T>
@@ -389,7 +577,7 @@ QString VisuConfiguration::toXML()
     xml += VisuMisc::openTag(TAG_VISU_CONFIG);
 
     // Configuration properties
-    xml += VisuMisc::addElement(TAG_NAME, mProperties, 1);
+    xml += VisuMisc::addElement(TAG_NAME, mProperties.map(), 1);
 
     // Signals
     xml += VisuMisc::openTag(TAG_SIGNALS_PLACEHOLDER, 1);
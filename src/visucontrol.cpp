@@ -2,7 +2,7 @@
 
 bool VisuControl::updateProperties(const QString &key, const QString &value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     VisuControl::loadProperties();
     return VisuControl::refresh(key);
 }
@@ -11,8 +11,8 @@ void VisuControl::loadProperties()
 {
     VisuWidget::loadProperties();
 
-    GET_PROPERTY(cActionIp, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cActionPort, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cActionIp, mProperties);
+    GET_PROPERTY(cActionPort, mProperties);
 
 }
 
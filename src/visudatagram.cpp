@@ -1,15 +1,31 @@
 #include "visudatagram.h"
 
-bool VisuDatagram::checksumOk()
+namespace
 {
-    quint8* ptr = (quint8*)this;
-    quint8* end = &(checksum);
-    quint8 sum = 0x0;
-
-    while (ptr != end)
+    template <typename T>
+    quint8 xorBytes(T value)
     {
-        sum ^= *ptr;
-        ++ptr;
+        quint8 sum = 0x0;
+        for (unsigned i = 0; i < sizeof(T); ++i)
+        {
+            sum ^= (quint8)(value >> (8 * i));
+        }
+        return sum;
     }
+}
+
+/**
+ * @brief VisuDatagram::checksumOk
+ * Checks XOR checksum over bytes of all fields. Result does not depend on
+ * byte order, so it matches checksum computed over wire bytes, nor does
+ * it depend on struct layout and padding.
+ * @return
+ */
+bool VisuDatagram::checksumOk()
+{
+    quint8 sum = xorBytes(signalId)
+               ^ xorBytes(packetNumber)
+               ^ xorBytes(timestamp)
+               ^ xorBytes(rawValue);
     return sum == checksum;
 }
@@ -0,0 +1,115 @@
+#include "visuingestqueue.h"
+#include "visuconfiguration.h"
+#include "visusignal.h"
+
+VisuIngestQueue::VisuIngestQueue(int capacity) : mBuffer(capacity),
+                                                 mDrainPending(false),
+                                                 mOverruns(0),
+                                                 mDrops(0),
+                                                 mDelivered(0)
+{
+}
+
+/**
+ * @brief VisuIngestQueue::push
+ * Called from ingest thread. Stores datagram and wakes up GUI thread,
+ * unless drain is already pending.
+ */
+void VisuIngestQueue::push(const VisuDatagram& datagram)
+{
+    if (!mBuffer.push(datagram))
+    {
+        mOverruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    scheduleDrain();
+}
+
+/**
+ * @brief VisuIngestQueue::push
+ * Stores datagrams that belong together, e.g. values parsed from one
+ * serial line, so that they are delivered in the same drain.
+ */
+void VisuIngestQueue::push(const VisuDatagram* datagrams, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (!mBuffer.push(datagrams[i]))
+        {
+            mOverruns.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    scheduleDrain();
+}
+
+void VisuIngestQueue::countDrop()
+{
+    mDrops.fetch_add(1, std::memory_order_relaxed);
+}
+
+void VisuIngestQueue::scheduleDrain()
+{
+    if (!mDrainPending.exchange(true))
+    {
+        QMetaObject::invokeMethod(this, "drain", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief VisuIngestQueue::drain
+ * Called in GUI thread. Delivers at most one buffer worth of datagrams,
+ * so that constant stream of data can not starve the event loop.
+ */
+void VisuIngestQueue::drain()
+{
+    mDrainPending.store(false);
+
+    QSharedPointer<const VisuSignalDispatch> dispatch = VisuConfiguration::get()->getSignalDispatch();
+    VisuDatagram datagram;
+    int budget = mBuffer.capacity();
+
+    while (budget-- > 0 && mBuffer.pop(datagram))
+    {
+        const VisuSignalDispatch::Entry* entry = dispatch->find(datagram.signalId);
+        if (entry != nullptr)
+        {
+            entry->signal->datagramUpdate(datagram);
+            mDelivered.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            countDrop();
+        }
+    }
+
+    if (!mBuffer.isEmpty())
+    {
+        scheduleDrain();
+    }
+}
+
+quint64 VisuIngestQueue::getOverruns() const
+{
+    return mOverruns.load(std::memory_order_relaxed);
+}
+
+quint64 VisuIngestQueue::getDrops() const
+{
+    return mDrops.load(std::memory_order_relaxed);
+}
+
+quint64 VisuIngestQueue::getDelivered() const
+{
+    return mDelivered.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief VisuIngestQueue::getFree
+ * Number of datagrams that can be pushed without overrun. Exact in
+ * ingest thread, as GUI thread can only make more room meanwhile.
+ */
+int VisuIngestQueue::getFree() const
+{
+    return mBuffer.capacity() - mBuffer.size();
+}
@@ -2,11 +2,16 @@
 
 #include <QPainter>
 #include <QStyleOption>
+#include <QPaintEvent>
 #include "visumisc.h"
+#include "visurenderscheduler.h"
+#include "visulatencytracer.h"
+#include "visustaticlayercache.h"
+#include <QCryptographicHash>
 
 bool VisuInstrument::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     VisuInstrument::loadProperties();
     return VisuInstrument::refresh(key);
 }
@@ -15,12 +20,12 @@ void VisuInstrument::loadProperties()
 {
     VisuWidget::loadProperties();
 
-    GET_PROPERTY(cSignalId, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorBackground, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorStatic, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cColorForeground, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cFontSize, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cFontType, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cSignalId, mProperties);
+    GET_PROPERTY(cColorBackground, mProperties);
+    GET_PROPERTY(cColorStatic, mProperties);
+    GET_PROPERTY(cColorForeground, mProperties);
+    GET_PROPERTY(cFontSize, mProperties);
+    GET_PROPERTY(cFontType, mProperties);
 
     setup();
 }
@@ -29,27 +34,41 @@ void VisuInstrument::setup()
 {
     VisuWidget::setup();
     mFirstRun = true;
-    mPixmap = QPixmap(cWidth, cHeight);
-    mPixmapStatic = QPixmap(cWidth, cHeight);
+    mPixmap = createLayer(cWidth, cHeight);
+    mPixmapStatic = createLayer(cWidth, cHeight);
+    mDynamicRect = QRect();
+    mVisualKeyValid = false;
     setAttribute(Qt::WA_TranslucentBackground);
     setGeometry(cX, cY, cWidth, cHeight);
 }
 
 /**
  * @brief Instrument::signalUpdated
- * Method used by signal to notify instrument of change.
+ * Method used by signal to notify instrument of change. Rendering is
+ * deferred to the next frame of the render scheduler.
  * @param signal
  */
 void VisuInstrument::signalUpdated(const VisuSignal* const signal)
 {
     this->mSignal = signal;
-    render();
+    VisuRenderScheduler::get()->schedule(this);
 }
 
 void VisuInstrument::initialUpdate(const VisuSignal* const signal)
 {
     mFirstRun = true;
-    signalUpdated(signal);
+    this->mSignal = signal;
+    render();
+}
+
+bool VisuInstrument::isRenderPending() const
+{
+    return mRenderPending;
+}
+
+void VisuInstrument::setRenderPending(bool pending)
+{
+    mRenderPending = pending;
 }
 
 quint16 VisuInstrument::getId()
@@ -62,44 +81,212 @@ quint16 VisuInstrument::getSignalId()
     return cSignalId;
 }
 
-void VisuInstrument::render()
+/**
+ * @brief VisuInstrument::render
+ * Renders instrument with current signal value, unless its visual key
+ * shows that pixels would not change.
+ * @return false if rendering was skipped
+ */
+bool VisuInstrument::render()
 {
-    mPixmap.fill(Qt::transparent);
+    // value is traced once, even if instrument renders it again
+    bool traced = VisuLatencyTracer::isEnabled()
+                  && mSignal != nullptr
+                  && mSignal->getTrace().updated > mTrace.updated;
+    quint64 renderStart = traced ? VisuLatencyTracer::now() : 0;
 
+    QRect dirty;
     if (mFirstRun)
     {
-        mPixmapStatic.fill(Qt::transparent);
-        QPainter painter_static(&mPixmapStatic);
-        painter_static.setRenderHint(QPainter::Antialiasing);
-        renderStatic(&painter_static);
+        renderStaticLayer();
         mFirstRun = false;
+        dirty = rect();
+    }
+
+    quint64 visualKey = 0;
+    bool keyed = getVisualKey(visualKey);
+    if (dirty.isEmpty() && keyed && mVisualKeyValid && visualKey == mVisualKey)
+    {
+        return false;
     }
+    mVisualKey = visualKey;
+    mVisualKeyValid = keyed;
 
-    QPainter painter_dynamic(&mPixmap);
+    // only area dynamic parts covered before or cover now is recomposited
+    QRect dynamicRect = prepareDynamic() & rect();
+    dirty |= mDynamicRect | dynamicRect;
+    mDynamicRect = dynamicRect;
+
+    QPainter painter_dynamic(mPixmap.device());
+    painter_dynamic.setClipRect(dirty);
+    painter_dynamic.setCompositionMode(QPainter::CompositionMode_Source);
+    mPixmapStatic.draw(&painter_dynamic, dirty, dirty);
+    painter_dynamic.setCompositionMode(QPainter::CompositionMode_SourceOver);
     painter_dynamic.setRenderHint(QPainter::Antialiasing);
-    painter_dynamic.drawPixmap(0, 0, mPixmapStatic);
     renderDynamic(&painter_dynamic);
 
-    update();
+    if (traced)
+    {
+        mTrace = mSignal->getTrace();
+        mTrace.renderStart = renderStart;
+        mTrace.renderEnd = VisuLatencyTracer::now();
+        mTracePending = true;
+    }
+
+    update(dirty);
+    return true;
+}
+
+/**
+ * @brief VisuInstrument::renderStaticLayer
+ * Renders static parts to mPixmapStatic, or takes layer rendered by
+ * identical instrument when instrument allows sharing it.
+ */
+void VisuInstrument::renderStaticLayer()
+{
+    bool shared = prepareStatic();
+    QByteArray key;
+    if (shared)
+    {
+        key = getStaticKey();
+        if (VisuStaticLayerCache::get()->find(key, mPixmapStatic))
+        {
+            return;
+        }
+    }
+
+    // never draw over layer shared with other instruments
+    mPixmapStatic = createLayer(cWidth, cHeight);
+    mPixmapStatic.fill(Qt::transparent);
+    {
+        QPainter painter_static(mPixmapStatic.device());
+        painter_static.setRenderHint(QPainter::Antialiasing);
+        renderStatic(&painter_static);
+    }
+
+    if (shared)
+    {
+        VisuStaticLayerCache::get()->insert(key, mPixmapStatic);
+    }
+}
+
+/**
+ * @brief VisuInstrument::prepareStatic
+ * Called before static layer is rendered or taken from cache. Instruments
+ * set up any layout state dynamic rendering depends on here, and return
+ * true if renderStatic has no other side effects and only depends on
+ * properties and connected signals, so its result can be shared by
+ * identical instruments. Not shareable by default.
+ */
+bool VisuInstrument::prepareStatic()
+{
+    return false;
+}
+
+/**
+ * @brief VisuInstrument::getStaticKey
+ * Hash of all properties, except position, id, name and signal
+ * assignment, and of range, unit and name of connected signals.
+ */
+QByteArray VisuInstrument::getStaticKey()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    const QMap<QString, QString>& properties = mProperties.map();
+    for (auto itr = properties.constBegin(); itr != properties.constEnd(); ++itr)
+    {
+        const QString& key = itr.key();
+        if (key == KEY_ID || key == KEY_X || key == KEY_Y || key == KEY_NAME
+            || mPropertiesMeta.value(key).type == VisuPropertyMeta::INSTSIGNAL)
+        {
+            continue;
+        }
+        hash.addData(QString("%1=%2\n").arg(key, itr.value()).toUtf8());
+    }
+
+    for (const QPointer<VisuSignal>& sig : connectedSignals)
+    {
+        if (sig != nullptr)
+        {
+            hash.addData(QString("signal=%1,%2,%3,%4\n")
+                         .arg(sig->getMin(), 0, 'g', 17)
+                         .arg(sig->getMax(), 0, 'g', 17)
+                         .arg(sig->getUnit(), sig->getName()).toUtf8());
+        }
+    }
+
+    return hash.result();
+}
+
+/**
+ * @brief VisuInstrument::prepareDynamic
+ * Called before renderDynamic, once static parts are rendered. Brings
+ * value dependent state up to date and returns bounding rectangle of
+ * everything renderDynamic will draw. Only that rectangle and the one
+ * returned previously are recomposited and repainted. Whole instrument
+ * is returned by default.
+ * @return
+ */
+QRect VisuInstrument::prepareDynamic()
+{
+    return rect();
+}
+
+/**
+ * @brief VisuInstrument::getVisualKey
+ * Called after static parts are rendered and before prepareDynamic, so
+ * state computed here can be used when rendering. Sets key to quantized state of
+ * current value that determines pixels of dynamic parts, e.g. pointer
+ * angle at pixel resolution or displayed text. Rendering is skipped while
+ * key stays the same. By default instrument has no key and is always
+ * rendered.
+ * @param key
+ * @return true if instrument has visual key
+ */
+bool VisuInstrument::getVisualKey(quint64& key)
+{
+    (void)key;
+    return false;
 }
 
 void VisuInstrument::paintEvent(QPaintEvent* event)
 {
-    (void)event;    // supress compiler warning about unused parameter
     QPainter painter(this);
 
-    // draw instrument
-    painter.drawPixmap(0, 0, mPixmap);
+    // draw only exposed part of instrument
+    QRect exposed = event->rect();
+    mPixmap.draw(&painter, exposed, exposed);
 
     drawActiveBox(&painter);
+
+    if (mTracePending)
+    {
+        mTrace.painted = VisuLatencyTracer::now();
+        VisuLatencyTracer::get()->record(cId, mTrace);
+        mTracePending = false;
+    }
 }
 
-void VisuInstrument::setFont(QPainter* painter)
+/**
+ * @brief VisuInstrument::createLayer
+ * Creates offscreen layer of type selected in configuration.
+ */
+VisuLayer VisuInstrument::createLayer(int width, int height)
+{
+    return VisuLayer(width, height, VisuConfiguration::get()->isRasterLayers());
+}
+
+QFont VisuInstrument::getFont()
 {
     QFont font;
     font.setPixelSize(cFontSize);
     font.setFamily(cFontType);
-    painter->setFont(font);
+    return font;
+}
+
+void VisuInstrument::setFont(QPainter* painter)
+{
+    painter->setFont(getFont());
 }
 
 void VisuInstrument::setPen(QPainter* painter, QColor color, int thickness)
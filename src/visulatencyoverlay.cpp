@@ -0,0 +1,23 @@
+#include "visulatencyoverlay.h"
+#include "visulatencytracer.h"
+#include <QFontDatabase>
+
+VisuLatencyOverlay::VisuLatencyOverlay(QWidget* parent) : QLabel(parent),
+                                                          mTimer(this)
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 160); color: white; padding: 4px; }");
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setText("Waiting for traced samples...");
+    adjustSize();
+
+    QObject::connect(&mTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+    mTimer.start(REFRESH_PERIOD);
+}
+
+void VisuLatencyOverlay::refresh()
+{
+    setText(VisuLatencyTracer::get()->getSummary().trimmed());
+    adjustSize();
+    raise();
+}
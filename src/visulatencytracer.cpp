@@ -0,0 +1,239 @@
+#include "visulatencytracer.h"
+#include <QFile>
+#include <QTextStream>
+#include <QtAlgorithms>
+
+namespace
+{
+    const char* const STAGE_NAMES[VisuTraceSample::STAGE_COUNT] = { "decode", "queue", "schedule", "render", "paint" };
+    const double NS_IN_US = 1000.0;
+    const double NS_IN_MS = 1000000.0;
+
+    quint64 stageStart(const VisuTraceSample& sample, int stage)
+    {
+        const quint64 points[] = { sample.received, sample.decoded, sample.updated, sample.renderStart, sample.renderEnd };
+        return points[stage];
+    }
+
+    quint64 stageEnd(const VisuTraceSample& sample, int stage)
+    {
+        const quint64 points[] = { sample.decoded, sample.updated, sample.renderStart, sample.renderEnd, sample.painted };
+        return points[stage];
+    }
+}
+
+VisuLatencyHistogram::VisuLatencyHistogram() : mBuckets(BUCKET_COUNT, 0),
+                                               mCount(0),
+                                               mMax(0)
+{
+}
+
+int VisuLatencyHistogram::bucketOf(quint64 value)
+{
+    if (value < (quint64)SUB_BUCKETS)
+    {
+        return (int)value;
+    }
+
+    int shift = 63 - qCountLeadingZeroBits(value) - SUB_BITS;
+    return shift * SUB_BUCKETS + (int)(value >> shift);
+}
+
+quint64 VisuLatencyHistogram::upperBoundOf(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    int shift = bucket / SUB_BUCKETS - 1;
+    quint64 mantissa = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void VisuLatencyHistogram::add(quint64 value)
+{
+    ++mBuckets[bucketOf(value)];
+    ++mCount;
+    mMax = qMax(mMax, value);
+}
+
+quint64 VisuLatencyHistogram::getCount() const
+{
+    return mCount;
+}
+
+quint64 VisuLatencyHistogram::getMax() const
+{
+    return mMax;
+}
+
+/**
+ * @brief VisuLatencyHistogram::getPercentile
+ * Returns upper bound of bucket holding given percentile, but never more
+ * than the largest recorded value.
+ * @param percentile in [0, 100]
+ */
+quint64 VisuLatencyHistogram::getPercentile(double percentile) const
+{
+    quint64 rank = qMax<quint64>(1, (quint64)(percentile / 100.0 * mCount + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += mBuckets[i];
+        if (seen >= rank)
+        {
+            return qMin(upperBoundOf(i), mMax);
+        }
+    }
+    return mMax;
+}
+
+VisuLatencyTracer* VisuLatencyTracer::instance = nullptr;
+bool VisuLatencyTracer::enabled = false;
+QElapsedTimer VisuLatencyTracer::clock;
+
+VisuLatencyTracer* VisuLatencyTracer::get()
+{
+    if (instance == nullptr)
+    {
+        instance = new VisuLatencyTracer();
+    }
+    return instance;
+}
+
+VisuLatencyTracer::VisuLatencyTracer() : mNextSample(0)
+{
+}
+
+/**
+ * @brief VisuLatencyTracer::enable
+ * Starts trace clock. Has to be called before server is started, as
+ * ingest thread only reads the flag.
+ */
+void VisuLatencyTracer::enable()
+{
+    if (!enabled)
+    {
+        clock.start();
+        mSamples.reserve(MAX_SAMPLES);
+        enabled = true;
+    }
+}
+
+/**
+ * @brief VisuLatencyTracer::now
+ * Trace clock time in ns. Monotonic and shared by all threads. Never 0,
+ * so 0 can mark missing stamp.
+ */
+quint64 VisuLatencyTracer::now()
+{
+    return clock.nsecsElapsed() + 1;
+}
+
+void VisuLatencyTracer::record(quint16 instrumentId, const VisuTraceSample& sample)
+{
+    mInstruments[instrumentId].add(sample.painted - sample.received);
+    for (int stage = 0; stage < VisuTraceSample::STAGE_COUNT; ++stage)
+    {
+        mStages[stage].add(stageEnd(sample, stage) - stageStart(sample, stage));
+    }
+
+    Recorded recorded = { instrumentId, sample };
+    if (mSamples.size() < MAX_SAMPLES)
+    {
+        mSamples.append(recorded);
+    }
+    else
+    {
+        mSamples[mNextSample] = recorded;
+    }
+    mNextSample = (mNextSample + 1) % MAX_SAMPLES;
+}
+
+QString VisuLatencyTracer::formatDuration(quint64 ns)
+{
+    return QString::number(ns / NS_IN_MS, 'f', 2);
+}
+
+QString VisuLatencyTracer::formatHistogram(const VisuLatencyHistogram& histogram)
+{
+    return QString("p50 %1  p99 %2  max %3 ms  (%4)")
+            .arg(formatDuration(histogram.getPercentile(50)), 6)
+            .arg(formatDuration(histogram.getPercentile(99)), 6)
+            .arg(formatDuration(histogram.getMax()), 6)
+            .arg(histogram.getCount());
+}
+
+/**
+ * @brief VisuLatencyTracer::getSummary
+ * Latency of every instrument, from packet arrival to paint, followed by
+ * latency of every stage over all instruments.
+ */
+QString VisuLatencyTracer::getSummary() const
+{
+    QString summary;
+    for (auto itr = mInstruments.constBegin(); itr != mInstruments.constEnd(); ++itr)
+    {
+        summary += QString("instrument %1  %2\n").arg(itr.key(), 4).arg(formatHistogram(itr.value()));
+    }
+    for (int stage = 0; stage < VisuTraceSample::STAGE_COUNT; ++stage)
+    {
+        summary += QString("%1  %2\n").arg(STAGE_NAMES[stage], 15).arg(formatHistogram(mStages[stage]));
+    }
+    return summary;
+}
+
+/**
+ * @brief VisuLatencyTracer::writeChromeTrace
+ * Writes recent samples in Chrome trace-event format. Every sample is
+ * nested async event, named by its instrument, with one child event per
+ * stage. Timestamps are in us since tracing was enabled.
+ * @return false if file could not be written
+ */
+bool VisuLatencyTracer::writeChromeTrace(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text))
+    {
+        return false;
+    }
+
+    QTextStream out(&file);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out.setRealNumberPrecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    bool first = true;
+    auto event = [&](const char* phase, const QString& name, int id, quint64 time, quint16 signalId)
+    {
+        out << (first ? "" : ",\n")
+            << "{\"cat\":\"latency\",\"ph\":\"" << phase
+            << "\",\"name\":\"" << name
+            << "\",\"id\":" << id
+            << ",\"pid\":1,\"tid\":1,\"ts\":" << time / NS_IN_US
+            << ",\"args\":{\"signal\":" << signalId << "}}";
+        first = false;
+    };
+
+    // oldest sample first
+    int start = mSamples.size() < MAX_SAMPLES ? 0 : mNextSample;
+    for (int i = 0; i < mSamples.size(); ++i)
+    {
+        const Recorded& recorded = mSamples[(start + i) % mSamples.size()];
+        const VisuTraceSample& sample = recorded.sample;
+        QString name = QString("instrument %1").arg(recorded.instrumentId);
+
+        event("b", name, i, sample.received, sample.signalId);
+        for (int stage = 0; stage < VisuTraceSample::STAGE_COUNT; ++stage)
+        {
+            event("b", STAGE_NAMES[stage], i, stageStart(sample, stage), sample.signalId);
+            event("e", STAGE_NAMES[stage], i, stageEnd(sample, stage), sample.signalId);
+        }
+        event("e", name, i, sample.painted, sample.signalId);
+    }
+
+    out << "\n]}\n";
+    out.flush();
+    return file.error() == QFile::NoError;
+}
@@ -0,0 +1,143 @@
+#include "visulayer.h"
+#include <string.h>
+
+VisuLayer::VisuLayer() : mRaster(false)
+{
+}
+
+VisuLayer::VisuLayer(int width, int height, bool raster) : mRaster(raster)
+{
+    if (mRaster)
+    {
+        mImage = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+    }
+    else
+    {
+        mPixmap = QPixmap(width, height);
+    }
+}
+
+QPaintDevice* VisuLayer::device()
+{
+    if (mRaster)
+    {
+        return &mImage;
+    }
+    return &mPixmap;
+}
+
+bool VisuLayer::isRaster() const
+{
+    return mRaster;
+}
+
+bool VisuLayer::isNull() const
+{
+    return mRaster ? mImage.isNull() : mPixmap.isNull();
+}
+
+/**
+ * @brief VisuLayer::isDetached
+ * True if no other layer shares data with this one.
+ */
+bool VisuLayer::isDetached() const
+{
+    return mRaster ? mImage.isDetached() : mPixmap.isDetached();
+}
+
+QRect VisuLayer::rect() const
+{
+    return mRaster ? mImage.rect() : mPixmap.rect();
+}
+
+QSize VisuLayer::size() const
+{
+    return mRaster ? mImage.size() : mPixmap.size();
+}
+
+/**
+ * @brief VisuLayer::byteCount
+ * Memory taken by layer, assuming 32 bits per pixel for pixmaps.
+ */
+int VisuLayer::byteCount() const
+{
+    if (mRaster)
+    {
+        return mImage.byteCount();
+    }
+    return mPixmap.width() * mPixmap.height() * 4;
+}
+
+void VisuLayer::fill(const QColor& color)
+{
+    if (mRaster)
+    {
+        mImage.fill(color);
+    }
+    else
+    {
+        mPixmap.fill(color);
+    }
+}
+
+/**
+ * @brief VisuLayer::scroll
+ * Moves content of rect by (dx, dy), same as QPixmap::scroll, which
+ * QImage lacks. Uncovered part of rect is left as it was.
+ */
+void VisuLayer::scroll(int dx, int dy, const QRect& rect)
+{
+    if (!mRaster)
+    {
+        mPixmap.scroll(dx, dy, rect);
+        return;
+    }
+
+    QRect dest = rect & mImage.rect();
+    QRect src = dest.translated(-dx, -dy) & dest;
+    if (src.isEmpty())
+    {
+        return;
+    }
+
+    const int pixelSize = 4;    // Format_ARGB32_Premultiplied
+    int bytesPerLine = mImage.bytesPerLine();
+    uchar* bits = mImage.bits();
+    int length = src.width() * pixelSize;
+
+    // rows are copied away from the direction they move to, so none is
+    // overwritten before it is copied
+    int first = dy > 0 ? src.bottom() : src.top();
+    int step = dy > 0 ? -1 : 1;
+    for (int i = 0; i < src.height(); ++i)
+    {
+        int y = first + i * step;
+        memmove(bits + (y + dy) * bytesPerLine + (src.x() + dx) * pixelSize,
+                bits + y * bytesPerLine + src.x() * pixelSize,
+                length);
+    }
+}
+
+void VisuLayer::draw(QPainter* painter, const QRect& target, const QRect& source) const
+{
+    if (mRaster)
+    {
+        painter->drawImage(target, mImage, source);
+    }
+    else
+    {
+        painter->drawPixmap(target, mPixmap, source);
+    }
+}
+
+void VisuLayer::draw(QPainter* painter, const QPoint& position) const
+{
+    if (mRaster)
+    {
+        painter->drawImage(position, mImage);
+    }
+    else
+    {
+        painter->drawPixmap(position, mPixmap);
+    }
+}
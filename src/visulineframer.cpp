@@ -0,0 +1,130 @@
+#include "visulineframer.h"
+#include <cstring>
+
+VisuLineFramer::VisuLineFramer(int capacity, char delimiter) : mBuffer(roundUp(capacity)),
+                                                               mScratch(mBuffer.size()),
+                                                               mMask(mBuffer.size() - 1),
+                                                               mHead(0),
+                                                               mTail(0),
+                                                               mScan(0),
+                                                               mDelimiter(delimiter),
+                                                               mDiscarding(false),
+                                                               mOverflows(0)
+{
+}
+
+size_t VisuLineFramer::roundUp(int capacity)
+{
+    size_t size = 1;
+    while (size < (size_t)capacity)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+/**
+ * @brief VisuLineFramer::getWriteBuffer
+ * Returns contiguous free space of the ring, to be filled by caller and
+ * then passed to commit(). Lines returned earlier become invalid.
+ * @param size set to number of bytes that can be written
+ * @return
+ */
+char* VisuLineFramer::getWriteBuffer(int& size)
+{
+    size_t used = mHead - mTail;
+    size_t offset = mHead & mMask;
+    size = (int)qMin(mBuffer.size() - used, mBuffer.size() - offset);
+    return mBuffer.data() + offset;
+}
+
+void VisuLineFramer::commit(int size)
+{
+    mHead += size;
+}
+
+/**
+ * @brief VisuLineFramer::nextLine
+ * Returns next complete line, without delimiter. Line stays valid until
+ * next call to getWriteBuffer.
+ * @param line
+ * @param length
+ * @return false if there is no complete line left
+ */
+bool VisuLineFramer::nextLine(const char*& line, int& length)
+{
+    while (mScan != mHead)
+    {
+        // search the contiguous part of unscanned data
+        size_t offset = mScan & mMask;
+        size_t size = qMin(mHead - mScan, mBuffer.size() - offset);
+        const char* start = mBuffer.data() + offset;
+        const char* found = (const char*)memchr(start, mDelimiter, size);
+        if (found == nullptr)
+        {
+            mScan += size;
+            continue;
+        }
+
+        size_t end = mScan + (found - start);
+        size_t lineLength = end - mTail;
+        size_t lineOffset = mTail & mMask;
+        mTail = end + 1;
+        mScan = mTail;
+
+        if (mDiscarding)
+        {
+            mDiscarding = false;
+            continue;
+        }
+
+        if (lineOffset + lineLength <= mBuffer.size())
+        {
+            line = mBuffer.data() + lineOffset;
+        }
+        else
+        {
+            size_t first = mBuffer.size() - lineOffset;
+            memcpy(mScratch.data(), mBuffer.data() + lineOffset, first);
+            memcpy(mScratch.data() + first, mBuffer.data(), lineLength - first);
+            line = mScratch.data();
+        }
+        length = (int)lineLength;
+        return true;
+    }
+
+    if (mHead - mTail == mBuffer.size())
+    {
+        // line longer than several rings is still counted once
+        if (!mDiscarding)
+        {
+            ++mOverflows;
+        }
+        mTail = mHead;
+        mDiscarding = true;
+    }
+    return false;
+}
+
+void VisuLineFramer::clear()
+{
+    mHead = 0;
+    mTail = 0;
+    mScan = 0;
+    mDiscarding = false;
+}
+
+void VisuLineFramer::setDelimiter(char delimiter)
+{
+    mDelimiter = delimiter;
+    clear();
+}
+
+/**
+ * @brief VisuLineFramer::getOverflows
+ * Number of lines discarded, because they did not fit the buffer.
+ */
+quint64 VisuLineFramer::getOverflows() const
+{
+    return mOverflows;
+}
@@ -1,6 +1,10 @@
 #include "visumisc.h"
 #include "visupropertyloader.h"
 
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
 void VisuMisc::setBackgroundColor(QWidget* widget, QColor color)
 {
     QString stylesheet = QString("background-color: %1;").arg(VisuMisc::colorToStr(color));
@@ -100,3 +104,24 @@ QImage VisuMisc::strToImage(const QString& str, const QString& format)
 
     return image;
 }
+
+/**
+ * @brief VisuMisc::getPeakMemoryKb
+ * Returns peak resident memory of the process, or 0 where it is not
+ * available.
+ */
+qint64 VisuMisc::getPeakMemoryKb()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef Q_OS_MAC
+        return usage.ru_maxrss / 1024;     // bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "visuproperties.h"
+
+VisuProperties::VisuProperties()
+{
+}
+
+VisuProperties::VisuProperties(const QMap<QString, QString>& properties) : mMap(properties)
+{
+}
+
+VisuProperties& VisuProperties::operator=(const QMap<QString, QString>& properties)
+{
+    mMap = properties;
+    assignSlots();
+    return *this;
+}
+
+/**
+ * @brief VisuProperties::setSchema
+ * Attaches compiled schema of element type. All values are marked as
+ * changed, so that next load reads them.
+ * @param schema
+ */
+void VisuProperties::setSchema(QSharedPointer<const VisuPropertySchema> schema)
+{
+    if (mSchema == schema)
+    {
+        return;
+    }
+    mSchema = schema;
+    assignSlots();
+}
+
+void VisuProperties::assignSlots()
+{
+    int size = mSchema.isNull() ? 0 : mSchema->size();
+    mSlots.resize(size);
+
+    for (int slot = 0; slot < size; ++slot)
+    {
+        auto itr = mMap.constFind(mSchema->key(slot));
+        mSlots[slot].present = (itr != mMap.constEnd());
+        mSlots[slot].value = mSlots[slot].present ? itr.value() : QString();
+        mSlots[slot].changed = true;
+    }
+}
+
+const QMap<QString, QString>& VisuProperties::map() const
+{
+    return mMap;
+}
+
+bool VisuProperties::contains(const QString& key) const
+{
+    return mMap.contains(key);
+}
+
+QString VisuProperties::value(const QString& key) const
+{
+    return mMap.value(key);
+}
+
+void VisuProperties::set(const QString& key, const QString& value)
+{
+    mMap[key] = value;
+
+    int slot = mSchema.isNull() ? -1 : mSchema->slot(key);
+    if (slot >= 0 && (!mSlots[slot].present || mSlots[slot].value != value))
+    {
+        mSlots[slot].value = value;
+        mSlots[slot].present = true;
+        mSlots[slot].changed = true;
+    }
+}
+
+void VisuProperties::swap(const QString& first, const QString& second)
+{
+    QString value = mMap.value(first);
+    set(first, mMap.value(second));
+    set(second, value);
+}
+
+bool VisuProperties::contains(int keyId) const
+{
+    int slot = mSchema.isNull() ? -1 : mSchema->slot(keyId);
+    return slot >= 0 ? mSlots[slot].present : mMap.contains(VisuPropertySchema::keyName(keyId));
+}
+
+const VisuPropertyMeta& VisuProperties::meta(int keyId) const
+{
+    static const VisuPropertyMeta noMeta;
+    int slot = mSchema.isNull() ? -1 : mSchema->slot(keyId);
+    return slot >= 0 ? mSchema->meta(slot) : noMeta;
+}
+
+/**
+ * @brief VisuProperties::take
+ * Returns value of property if it changed since it was last taken, or
+ * nullptr if it did not. Properties unknown to the schema are always
+ * returned.
+ * @param keyId
+ * @return
+ */
+const QString* VisuProperties::take(int keyId)
+{
+    int slot = mSchema.isNull() ? -1 : mSchema->slot(keyId);
+    if (slot < 0)
+    {
+        auto itr = mMap.constFind(VisuPropertySchema::keyName(keyId));
+        return itr != mMap.constEnd() ? &itr.value() : nullptr;
+    }
+
+    if (!mSlots[slot].changed)
+    {
+        return nullptr;
+    }
+    mSlots[slot].changed = false;
+    return &mSlots[slot].value;
+}
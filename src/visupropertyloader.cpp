@@ -12,77 +12,97 @@ namespace VisuPropertyLoader
         return key.mid(1, 1).toLower() + key.mid(2);
     }
 
-    void handleMissingKey(const QString &key,
-                          QMap<QString, QString>& properties,
-                          const QMap<QString, VisuPropertyMeta>& metaProperties)
+    /**
+     * @brief take
+     * Returns property value if it has to be loaded, nullptr if it did not
+     * change since the last load. Missing optional property gets its
+     * default value, other missing properties are errors outside editor.
+     */
+    const QString* take(int keyId, VisuProperties& properties)
     {
-        if (!properties.contains(key))
+        if (!properties.contains(keyId))
         {
-            ConfigLoadException exception(QObject::tr("Missing property: %1 (%2)").arg(metaProperties[key].label).arg(key));
+            const QString& key = VisuPropertySchema::keyName(keyId);
+            const VisuPropertyMeta& meta = properties.meta(keyId);
+            if (meta.optional)
+            {
+                properties.set(key, meta.defaultVal);
+                return properties.take(keyId);
+            }
+
+            ConfigLoadException exception(QObject::tr("Missing property: %1 (%2)").arg(meta.label).arg(key));
             VisuAppInfo::setConfigWrong(exception.getMessage());
 
             if (VisuAppInfo::isInEditorMode())
             {
-                properties[key] = metaProperties[key].defaultVal;
+                properties.set(key, meta.defaultVal);
             }
             else
             {
                 throw exception;
             }
         }
+
+        return properties.take(keyId);
     }
 
-    void set(double& property,
-                       const QString& key,
-                       QMap<QString, QString>& properties,
-                       const QMap<QString, VisuPropertyMeta>& metaProperties)
+    void set(double& property, int keyId, VisuProperties& properties)
     {
-        handleMissingKey(key, properties, metaProperties);
-        property = properties[key].toDouble();
+        const QString* value = take(keyId, properties);
+        if (value != nullptr)
+        {
+            property = value->toDouble();
+        }
     }
 
 
-    void set(QString& property,
-                         const QString& key,
-                         QMap<QString, QString>& properties,
-                         const QMap<QString, VisuPropertyMeta>& metaProperties)
+    void set(QString& property, int keyId, VisuProperties& properties)
     {
-        handleMissingKey(key, properties, metaProperties);
-        property = properties[key];
+        const QString* value = take(keyId, properties);
+        if (value != nullptr)
+        {
+            property = *value;
+        }
     }
 
 
-    void set( QColor& property,
-              const QString& key,
-              QMap<QString, QString>& properties,
-              const QMap<QString, VisuPropertyMeta>& metaProperties)
+    void set(QColor& property, int keyId, VisuProperties& properties)
     {
-        handleMissingKey(key, properties, metaProperties);
+        const QString* value = take(keyId, properties);
+        if (value == nullptr)
+        {
+            return;
+        }
 
-        QColor color = VisuMisc::strToColor(properties[key]);
+        QColor color = VisuMisc::strToColor(*value);
         if (!color.isValid())
         {
-            throw ConfigLoadException("Wrong color format (%1)", properties[key]);
+            throw ConfigLoadException("Wrong color format (%1)", *value);
         }
         property = color;
     }
 
 
-    void set(QImage& property,
-             const QString& key,
-             QMap<QString, QString>& properties,
-             const QMap<QString, VisuPropertyMeta>& metaProperties)
+    void set(QImage& property, int keyId, VisuProperties& properties)
     {
-        handleMissingKey(key, properties, metaProperties);
-        property = VisuMisc::strToImage(properties[key], properties[StaticImage::KEY_FORMAT]);
+        static const int formatKeyId = VisuPropertySchema::keyId(StaticImage::KEY_FORMAT);
+
+        // image has to be decoded again when either data or format changes
+        bool imageChanged = (take(keyId, properties) != nullptr);
+        bool formatChanged = (properties.take(formatKeyId) != nullptr);
+        if (imageChanged || formatChanged)
+        {
+            const QString& key = VisuPropertySchema::keyName(keyId);
+            property = VisuMisc::strToImage(properties.value(key), properties.value(StaticImage::KEY_FORMAT));
+        }
     }
 
-    void set(bool& property,
-                   const QString& key,
-                   QMap<QString, QString>& properties,
-                   const QMap<QString, VisuPropertyMeta>& metaProperties)
+    void set(bool& property, int keyId, VisuProperties& properties)
     {
-        handleMissingKey(key, properties, metaProperties);
-        property = (properties[key].toInt() != 0);
+        const QString* value = take(keyId, properties);
+        if (value != nullptr)
+        {
+            property = (value->toInt() != 0);
+        }
     }
 }
@@ -7,6 +7,7 @@ const QString VisuPropertyMeta::KEY_EXTRA = "extra";
 const QString VisuPropertyMeta::KEY_LABEL = "label";
 const QString VisuPropertyMeta::KEY_DEPENDS = "depends";
 const QString VisuPropertyMeta::KEY_DEPSCRIPTION = "description";
+const QString VisuPropertyMeta::KEY_OPTIONAL = "optional";
 const QString VisuPropertyMeta::DELIMITER = ",";
 #include <QtCore>
 const char* VisuPropertyMeta::TYPES_MAP[] =
@@ -79,3 +80,40 @@ VisuPropertyMeta::Type VisuPropertyMeta::typeFromString(QString typeStr)
 
      return ret;
 }
+
+QDataStream& operator<<(QDataStream& stream, const VisuPropertyMeta& meta)
+{
+    stream << meta.min
+           << meta.max
+           << meta.defaultVal
+           << (qint32)meta.type
+           << meta.extra
+           << meta.label
+           << (qint32)meta.order
+           << meta.depends
+           << meta.description
+           << meta.optional;
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, VisuPropertyMeta& meta)
+{
+    qint32 type;
+    qint32 order;
+    stream >> meta.min
+           >> meta.max
+           >> meta.defaultVal
+           >> type
+           >> meta.extra
+           >> meta.label
+           >> order
+           >> meta.depends
+           >> meta.description
+           >> meta.optional;
+
+    meta.type = (type >= VisuPropertyMeta::FIRST && type <= VisuPropertyMeta::LAST)
+                ? (VisuPropertyMeta::Type)type
+                : VisuPropertyMeta::DEFAULT;
+    meta.order = order;
+    return stream;
+}
@@ -0,0 +1,89 @@
+#include "visupropertyschema.h"
+
+QHash<QString, int> VisuPropertySchema::keyIds;
+QVector<QString> VisuPropertySchema::keyNames;
+QHash<QString, QSharedPointer<const VisuPropertySchema>> VisuPropertySchema::schemas;
+
+/**
+ * @brief VisuPropertySchema::keyId
+ * Returns id of property key, assigning new one on first use. Callers are
+ * expected to resolve ids once and keep them (see GET_PROPERTY).
+ */
+int VisuPropertySchema::keyId(const QString& key)
+{
+    auto itr = keyIds.constFind(key);
+    if (itr != keyIds.constEnd())
+    {
+        return itr.value();
+    }
+
+    int id = keyNames.size();
+    keyIds.insert(key, id);
+    keyNames.append(key);
+    return id;
+}
+
+const QString& VisuPropertySchema::keyName(int keyId)
+{
+    return keyNames.at(keyId);
+}
+
+/**
+ * @brief VisuPropertySchema::compile
+ * Returns schema for given type, compiling it from meta on first request.
+ * @param type
+ * @param meta
+ * @return
+ */
+QSharedPointer<const VisuPropertySchema> VisuPropertySchema::compile(const QString& type,
+                                                                     const QMap<QString, VisuPropertyMeta>& meta)
+{
+    QSharedPointer<const VisuPropertySchema> schema = schemas.value(type);
+    if (schema.isNull())
+    {
+        schema = QSharedPointer<const VisuPropertySchema>(new VisuPropertySchema(meta));
+        schemas.insert(type, schema);
+    }
+    return schema;
+}
+
+VisuPropertySchema::VisuPropertySchema(const QMap<QString, VisuPropertyMeta>& meta)
+{
+    for (auto itr = meta.constBegin(); itr != meta.constEnd(); ++itr)
+    {
+        int id = keyId(itr.key());
+        while (mSlots.size() <= id)
+        {
+            mSlots.append(-1);
+        }
+        mSlots[id] = mKeys.size();
+        mKeys.append(itr.key());
+        mMeta.append(itr.value());
+    }
+}
+
+int VisuPropertySchema::size() const
+{
+    return mKeys.size();
+}
+
+int VisuPropertySchema::slot(int keyId) const
+{
+    return (keyId >= 0 && keyId < mSlots.size()) ? mSlots[keyId] : -1;
+}
+
+int VisuPropertySchema::slot(const QString& key) const
+{
+    auto itr = keyIds.constFind(key);
+    return itr != keyIds.constEnd() ? slot(itr.value()) : -1;
+}
+
+const QString& VisuPropertySchema::key(int slot) const
+{
+    return mKeys.at(slot);
+}
+
+const VisuPropertyMeta& VisuPropertySchema::meta(int slot) const
+{
+    return mMeta.at(slot);
+}
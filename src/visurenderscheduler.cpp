@@ -0,0 +1,113 @@
+#include "visurenderscheduler.h"
+#include "visuinstrument.h"
+#include "visuconfiguration.h"
+
+VisuRenderScheduler* VisuRenderScheduler::instance = nullptr;
+
+VisuRenderScheduler* VisuRenderScheduler::get()
+{
+    if (instance == nullptr)
+    {
+        instance = new VisuRenderScheduler();
+    }
+    return instance;
+}
+
+VisuRenderScheduler::VisuRenderScheduler() : mFramesRendered(0),
+                                             mInstrumentsRendered(0),
+                                             mUpdatesCoalesced(0),
+                                             mRendersSkipped(0)
+{
+    mTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&mTimer, SIGNAL(timeout()), this, SLOT(renderFrame()));
+}
+
+/**
+ * @brief VisuRenderScheduler::schedule
+ * Marks instrument as dirty. With frame rate limit set to 0, instrument is
+ * rendered immediately, as it was done before frames were introduced.
+ * @param instrument
+ */
+void VisuRenderScheduler::schedule(VisuInstrument* instrument)
+{
+    quint16 fps = VisuConfiguration::get()->getRenderFps();
+    if (fps == 0)
+    {
+        countRender(instrument->render());
+        return;
+    }
+
+    if (instrument->isRenderPending())
+    {
+        ++mUpdatesCoalesced;
+        return;
+    }
+
+    instrument->setRenderPending(true);
+    mDirty.append(instrument);
+
+    if (!mTimer.isActive())
+    {
+        mTimer.start(qMax(1, MS_IN_SECOND / fps));
+    }
+}
+
+void VisuRenderScheduler::renderFrame()
+{
+    if (mDirty.isEmpty())
+    {
+        mTimer.stop();
+        return;
+    }
+
+    // Instruments may be scheduled again while rendering, so work on a copy
+    mRendering.swap(mDirty);
+    for (VisuInstrument* instrument : mRendering)
+    {
+        if (instrument != nullptr)
+        {
+            instrument->setRenderPending(false);
+            countRender(instrument->render());
+        }
+    }
+    mRendering.resize(0);
+
+    ++mFramesRendered;
+}
+
+quint64 VisuRenderScheduler::getFramesRendered() const
+{
+    return mFramesRendered;
+}
+
+quint64 VisuRenderScheduler::getInstrumentsRendered() const
+{
+    return mInstrumentsRendered;
+}
+
+quint64 VisuRenderScheduler::getUpdatesCoalesced() const
+{
+    return mUpdatesCoalesced;
+}
+
+/**
+ * @brief VisuRenderScheduler::getRendersSkipped
+ * Renders skipped by instruments, because visual key of new value was the
+ * same as of the displayed one.
+ */
+quint64 VisuRenderScheduler::getRendersSkipped() const
+{
+    return mRendersSkipped;
+}
+
+void VisuRenderScheduler::countRender(bool rendered)
+{
+    if (rendered)
+    {
+        ++mInstrumentsRendered;
+    }
+    else
+    {
+        ++mRendersSkipped;
+    }
+}
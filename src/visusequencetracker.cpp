@@ -0,0 +1,142 @@
+#include "visusequencetracker.h"
+
+VisuSequenceTracker::VisuSequenceTracker() : mDropStale(false),
+                                             mChanged(false)
+{
+}
+
+void VisuSequenceTracker::setDropStale(bool dropStale)
+{
+    mDropStale = dropStale;
+}
+
+/**
+ * @brief VisuSequenceTracker::update
+ * Judges packet number against the last one seen in stats.
+ * @param samples number of samples carried by packet
+ * @return false if packet is stale and should be dropped
+ */
+bool VisuSequenceTracker::update(VisuSequenceStats& stats, quint16 packetNumber, int samples)
+{
+    mChanged = true;
+
+    qint16 delta = (qint16)(packetNumber - stats.lastPacketNumber);
+    if (delta > 0 || delta < -MAX_REORDER)
+    {
+        if (delta > 0)
+        {
+            stats.gaps += delta - 1;
+        }
+        else
+        {
+            ++stats.resets;
+        }
+        stats.lastPacketNumber = packetNumber;
+        return true;
+    }
+
+    if (delta == 0)
+    {
+        ++stats.duplicates;
+    }
+    else
+    {
+        ++stats.reordered;
+    }
+
+    if (mDropStale)
+    {
+        stats.staleDropped += samples;
+    }
+    return !mDropStale;
+}
+
+/**
+ * @brief VisuSequenceTracker::accept
+ * Updates statistics of signal with packet number of single datagram.
+ * @param signalId
+ * @param packetNumber
+ * @return false if sample is stale and should be dropped
+ */
+bool VisuSequenceTracker::accept(quint16 signalId, quint16 packetNumber)
+{
+    auto itr = mSignals.find(signalId);
+    if (itr == mSignals.end())
+    {
+        VisuSequenceStats stats = {};
+        stats.received = 1;
+        stats.lastPacketNumber = packetNumber;
+        mSignals.insert(signalId, stats);
+        mChanged = true;
+        return true;
+    }
+
+    ++itr.value().received;
+    return update(itr.value(), packetNumber, 1);
+}
+
+/**
+ * @brief VisuSequenceTracker::acceptFrame
+ * Updates statistics of source with packet number of batched frame.
+ * @param source sender address and port, or SERIAL_SOURCE
+ * @param packetNumber
+ * @param samples number of samples in frame
+ * @return false if whole frame is stale and should be dropped
+ */
+bool VisuSequenceTracker::acceptFrame(quint64 source, quint16 packetNumber, int samples)
+{
+    auto itr = mFrames.find(source);
+    if (itr == mFrames.end())
+    {
+        VisuSequenceStats stats = {};
+        stats.received = 1;
+        stats.lastPacketNumber = packetNumber;
+        mFrames.insert(source, stats);
+        mChanged = true;
+        return true;
+    }
+
+    ++itr.value().received;
+    return update(itr.value(), packetNumber, samples);
+}
+
+/**
+ * @brief VisuSequenceTracker::publish
+ * Called periodically by ingest thread. Copies statistics for other
+ * threads, if they changed since last copy.
+ */
+void VisuSequenceTracker::publish()
+{
+    if (!mChanged)
+    {
+        return;
+    }
+
+    QMap<quint16, VisuSequenceStats> signalStats;
+    for (auto itr = mSignals.constBegin(); itr != mSignals.constEnd(); ++itr)
+    {
+        signalStats.insert(itr.key(), itr.value());
+    }
+    QMap<quint64, VisuSequenceStats> frameStats;
+    for (auto itr = mFrames.constBegin(); itr != mFrames.constEnd(); ++itr)
+    {
+        frameStats.insert(itr.key(), itr.value());
+    }
+
+    QMutexLocker locker(&mMutex);
+    mSignalsSnapshot.swap(signalStats);
+    mFramesSnapshot.swap(frameStats);
+    mChanged = false;
+}
+
+QMap<quint16, VisuSequenceStats> VisuSequenceTracker::getStats() const
+{
+    QMutexLocker locker(&mMutex);
+    return mSignalsSnapshot;
+}
+
+QMap<quint64, VisuSequenceStats> VisuSequenceTracker::getFrameStats() const
+{
+    QMutexLocker locker(&mMutex);
+    return mFramesSnapshot;
+}
@@ -4,27 +4,76 @@
 #include "visuappinfo.h"
 #include <QRegularExpressionMatch>
 #include <QDateTime>
+#include "visurenderscheduler.h"
+#include "visustaticlayercache.h"
+#include "visuwirecodec.h"
 
-const QByteArray VisuServer::DELIMITER = QByteArray("\n");
+#define RECORD_OPTION "record"
+#define REPLAY_OPTION "replay"
+#define REPLAY_SPEED_OPTION "replay-speed"
 
 void VisuServer::handleSerialError(QSerialPort::SerialPortError serialPortError)
 {
     qDebug() << "Serial error: " << serialPortError;
 }
 
-VisuServer::VisuServer()
+VisuServer::VisuServer() : mSocket(this),
+                           mBulkSocket(nullptr),
+                           mTimer(this),
+                           mSerialPort(nullptr),
+                           mPublishTimer(this),
+                           mReplaying(false),
+                           mReplaySpeed(1.0),
+                           mReplayPosition(0),
+                           mReplayBase(0),
+                           mReplayTimer(this),
+                           mTraceReceived(0)
 {
+    mIngestThread.setObjectName("VisuIngest");
+    mIngestQueue = new VisuIngestQueue();
+
     mConfiguration = VisuConfiguration::get();
     mConectivity = (enum Connectivity)mConfiguration->getConectivity();
+    mSequenceTracker.setDropStale(mConfiguration->isDropStaleSamples());
+    QObject::connect(&mPublishTimer, SIGNAL(timeout()), this, SLOT(publishStats()));
+    mPublishTimer.setInterval(VisuSequenceTracker::PUBLISH_INTERVAL_MS);
+    mSerialProtocol = (enum SerialProtocol)mConfiguration->getSerialProtocol();
+    if (mSerialProtocol == SERIAL_BINARY_COBS)
+    {
+        mSerialFramer.setDelimiter('\0');
+        mSerialFrame.resize(VisuLineFramer::DEFAULT_CAPACITY);
+    }
     if (mConfiguration->isSerialBindToSignal())
     {
         mSerialRegex = QRegularExpression(mConfiguration->getSerialRegex());
     }
 
+    if (VisuAppInfo::hasCLIOption(REPLAY_OPTION))
+    {
+        // replayed log replaces all inputs
+        mReplaying = true;
+        mReplaySpeed = qMax(0.0, VisuAppInfo::getCLIOption(REPLAY_SPEED_OPTION, "1").toDouble());
+        QObject::connect(&mReplayTimer, SIGNAL(timeout()), this, SLOT(replayNext()));
+        VisuAppInfo::setServer(this);
+        return;
+    }
+
     if (mConectivity != SERIAL_ONLY)
     {
         mPort = mConfiguration->getPort();
-        QObject::connect(&mSocket, SIGNAL(readyRead()), this, SLOT(handleDatagram()));
+        if (mConfiguration->isUdpBulkReceive() && VisuBulkUdpSocket::isSupported())
+        {
+            mBulkSocket = new VisuBulkUdpSocket(mConfiguration->getUdpBatchSize(), this);
+            QObject::connect(mBulkSocket, SIGNAL(readyRead()), this, SLOT(handleBulkDatagrams()));
+        }
+        else
+        {
+            if (mConfiguration->isUdpBulkReceive())
+            {
+                qDebug("UDP bulk receive not supported on this platform.");
+            }
+            QObject::connect(&mSocket, SIGNAL(readyRead()), this, SLOT(handleDatagram()));
+        }
     }
 
     if (mConectivity != UDP_ONLY)
@@ -40,8 +89,72 @@ VisuServer::VisuServer()
     VisuAppInfo::setServer(this);
 }
 
+VisuServer::~VisuServer()
+{
+    stop();
+    delete mIngestQueue;
+}
+
+VisuIngestQueue* VisuServer::getIngestQueue()
+{
+    return mIngestQueue;
+}
+
+/**
+ * @brief VisuServer::getKernelDrops
+ * Datagrams dropped by the kernel because socket buffer was full. Known
+ * only with bulk receive, otherwise 0.
+ */
+quint64 VisuServer::getKernelDrops() const
+{
+    return mBulkSocket != nullptr ? mBulkSocket->getKernelDrops() : 0;
+}
+
+/**
+ * @brief VisuServer::getMetrics
+ * Collects counters of network, ingest thread and rendering. Has to be
+ * called from GUI thread, which owns render scheduler.
+ */
+VisuMetrics VisuServer::getMetrics() const
+{
+    VisuMetrics metrics;
+
+    metrics.kernelDrops = getKernelDrops();
+    metrics.sources = mSequenceTracker.getStats();
+    metrics.frameSources = mSequenceTracker.getFrameStats();
+
+    metrics.malformed = mIngestQueue->getDrops();
+    metrics.staleDropped = 0;
+    for (const VisuSequenceStats& stats : metrics.sources)
+    {
+        metrics.staleDropped += stats.staleDropped;
+    }
+    for (const VisuSequenceStats& stats : metrics.frameSources)
+    {
+        metrics.staleDropped += stats.staleDropped;
+    }
+    metrics.overruns = mIngestQueue->getOverruns();
+    metrics.delivered = mIngestQueue->getDelivered();
+
+    VisuRenderScheduler* scheduler = VisuRenderScheduler::get();
+    metrics.framesRendered = scheduler->getFramesRendered();
+    metrics.instrumentsRendered = scheduler->getInstrumentsRendered();
+    metrics.updatesCoalesced = scheduler->getUpdatesCoalesced();
+    metrics.rendersSkipped = scheduler->getRendersSkipped();
+    metrics.staticLayersShared = VisuStaticLayerCache::get()->getLayersShared();
+
+    return metrics;
+}
+
 void VisuServer::sendSerial(const QByteArray& data)
 {
+    if (QThread::currentThread() != thread())
+    {
+        // Serial port belongs to ingest thread, forward the request there
+        QMetaObject::invokeMethod(this, "sendSerial", Qt::QueuedConnection, Q_ARG(QByteArray, data));
+        return;
+    }
+
     if (mSerialPort != nullptr)
     {
         qint64 bytesWritten = mSerialPort->write(data);
@@ -61,87 +174,230 @@ void VisuServer::sendSerial(const QByteArray& data)
     }
 }
 
-void VisuServer::parseVisuSerial()
+void VisuServer::parseVisuSerial(const char* line, int length)
 {
-    mSerialBuffer.remove(0, mSerialBuffer.lastIndexOf(">") + 1);
-
     VisuDatagram datagram;
-    QString serialBufferString(mSerialBuffer);
-    QTextStream serialText(&serialBufferString);
-
-    uint cs;
-    serialText >> datagram.signalId >> datagram.packetNumber >> datagram.rawValue >> datagram.timestamp >> cs;
-    datagram.checksum = (quint8) cs;
-
-    if (datagram.checksumOk())
+    if (VisuWireCodec::decodeText(line, line + length, datagram) && datagram.checksumOk())
     {
-        updateSignal(datagram);
+        updateSequencedSignal(datagram);
     }
     else
     {
+        mIngestQueue->countDrop();
         qDebug("Bad serial package.");
     }
 }
 
-void VisuServer::parseRegexSerial()
+/**
+ * @brief VisuServer::parseBinarySerial
+ * Decodes COBS frame and handles its contents as UDP datagram would be.
+ * Frame corrupted by line noise fails decoding or checksum, and framing
+ * resumes at the next zero byte.
+ */
+void VisuServer::parseBinarySerial(const quint8* frame, int length)
 {
-    QString serialBufferString(mSerialBuffer);
-    QRegularExpressionMatch match = mSerialRegex.match(serialBufferString);
-    if (match.hasMatch())
+    int size = VisuWireCodec::decodeCobs(frame, length, mSerialFrame.data());
+    if (size < 0)
     {
-        QStringList values = match.capturedTexts();
+        mIngestQueue->countDrop();
+        qDebug("Bad serial frame.");
+        return;
+    }
+
+    handleDatagramBuffer(mSerialFrame.constData(), size, VisuSequenceTracker::SERIAL_SOURCE);
+}
+
+/**
+ * @brief VisuServer::setupSerialBindings
+ * Compiles serial regex and maps its capture groups to signals, so that
+ * signals do not have to be looked at for every line. Signals bound to
+ * group which regex does not have are skipped.
+ */
+void VisuServer::setupSerialBindings()
+{
+    mSerialRegex.optimize();
+    int captureCount = mSerialRegex.captureCount();
 
-        QVector<QPointer<VisuSignal>> signalsList = mConfiguration->getSignals();
-        for (VisuSignal* signal : signalsList)
+    mSerialBindings.clear();
+    QSharedPointer<const VisuSignalDispatch> dispatch = mConfiguration->getSignalDispatch();
+    for (quint16 signalId : dispatch->getIds())
+    {
+        const VisuSignalDispatch::Entry* entry = dispatch->find(signalId);
+        if (entry->serialPlaceholder <= 0)
         {
-            int valueIndex = signal->getSerialPlaceholder();
-            if (valueIndex > 0)
-            {
-                VisuDatagram datagram;
-                datagram.signalId = signal->getId();
-
-                QString value = values[valueIndex];
-                if (signal->getSerialTransform())
-                {
-                    datagram.rawValue = value.toInt();
-                }
-                else
-                {
-                    datagram.rawValue = (int)((value.toDouble() - signal->getOffset()) / signal->getFactor());
-                }
-                datagram.timestamp = QDateTime::currentDateTime().toMSecsSinceEpoch();
-                updateSignal(datagram);
-            }
+            continue;
         }
+
+        if (entry->serialPlaceholder > captureCount)
+        {
+            qDebug("Signal %d bound to group %d, but serial regex has only %d groups.",
+                   signalId, entry->serialPlaceholder, captureCount);
+            continue;
+        }
+
+        SerialBinding binding = { signalId,
+                                  entry->serialPlaceholder,
+                                  entry->serialTransform,
+                                  entry->factor,
+                                  entry->offset };
+        mSerialBindings.append(binding);
     }
+    mSerialBatch.reserve(mSerialBindings.size());
 }
 
-void VisuServer::handleSerial()
+/**
+ * @brief VisuServer::parseRegexSerial
+ * Matches line against serial regex and updates all bound signals at
+ * once, with the same timestamp.
+ */
+void VisuServer::parseRegexSerial(const char* line, int length)
 {
-    mSerialBuffer.append(mSerialPort->readAll());
+    // regex works on UTF-16, line is widened into reused string, so that
+    // nothing is allocated per line
+    mSerialLine.resize(length);
+    QChar* chars = mSerialLine.data();
+    for (int i = 0; i < length; ++i)
+    {
+        chars[i] = QChar((uchar)line[i]);
+    }
 
-    int pos = mSerialBuffer.indexOf(DELIMITER);
-    if (pos > 0)
+    QRegularExpressionMatch match = mSerialRegex.match(mSerialLine);
+    if (!match.hasMatch())
     {
-        if (mConfiguration->isSerialBindToSignal() && mSerialRegex.isValid())
+        return;
+    }
+
+    quint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    quint64 traceDecoded = VisuLatencyTracer::isEnabled() ? VisuLatencyTracer::now() : 0;
+    mSerialBatch.resize(0);
+    for (const SerialBinding& binding : mSerialBindings)
+    {
+        VisuDatagram datagram;
+        datagram.signalId = binding.signalId;
+        datagram.packetNumber = 0;
+        datagram.timestamp = timestamp;
+        datagram.checksum = 0x0;
+        datagram.traceReceived = mTraceReceived;
+        datagram.traceDecoded = traceDecoded;
+
+        QStringRef value = match.capturedRef(binding.captureGroup);
+        if (binding.transform)
         {
-            parseRegexSerial();
+            datagram.rawValue = value.toInt();
         }
         else
         {
-            parseVisuSerial();
+            datagram.rawValue = (int)((value.toDouble() - binding.offset) / binding.factor);
         }
+        mSerialBatch.append(datagram);
+    }
 
-        mSerialBuffer.remove(0, pos + DELIMITER.size());
+    if (mRecorder.isOpen())
+    {
+        mRecorder.record(mSerialBatch.constData(), mSerialBatch.size());
     }
+    mIngestQueue->push(mSerialBatch.constData(), mSerialBatch.size());
+}
+
+/**
+ * @brief VisuServer::handleSerial
+ * Reads serial port straight into line framer and handles every complete
+ * line, until port has no more data. In binary protocol lines are COBS
+ * frames, delimited by zero byte.
+ */
+void VisuServer::handleSerial()
+{
+    bool binary = (mSerialProtocol == SERIAL_BINARY_COBS);
+    bool regex = !binary && mConfiguration->isSerialBindToSignal() && mSerialRegex.isValid();
+
+    do
+    {
+        int size;
+        char* buffer = mSerialFramer.getWriteBuffer(size);
+        qint64 bytesRead = mSerialPort->read(buffer, size);
+        if (bytesRead <= 0)
+        {
+            break;
+        }
+        mSerialFramer.commit(bytesRead);
+        stampReceived();
+
+        const char* line;
+        int length;
+        while (mSerialFramer.nextLine(line, length))
+        {
+            if (length == 0)
+            {
+                continue;
+            }
+
+            if (binary)
+            {
+                parseBinarySerial((const quint8*)line, length);
+            }
+            else if (regex)
+            {
+                parseRegexSerial(line, length);
+            }
+            else
+            {
+                parseVisuSerial(line, length);
+            }
+        }
+    } while (mSerialPort->bytesAvailable() > 0);
 }
 
 void VisuServer::start()
 {
+    if (VisuAppInfo::hasCLIOption(RECORD_OPTION))
+    {
+        ConfigLoadException::setContext("starting recording");
+        QString recordPath = VisuAppInfo::getCLIOption(RECORD_OPTION);
+        if (!mRecorder.open(recordPath))
+        {
+            throw ConfigLoadException(QObject::tr("Failed to create record %1"), recordPath);
+        }
+        qDebug("Recording datagrams to %s.", recordPath.toStdString().c_str());
+    }
+
+    // moved to ingest thread together with server
+    mPublishTimer.start();
+
+    if (mReplaying)
+    {
+        ConfigLoadException::setContext("starting replay");
+        QString replayPath = VisuAppInfo::getCLIOption(REPLAY_OPTION);
+        if (!mReplay.open(replayPath))
+        {
+            throw ConfigLoadException(QObject::tr("Failed to open record %1"), replayPath);
+        }
+
+        moveToThread(&mIngestThread);
+        mIngestThread.start();
+        QMetaObject::invokeMethod(this, "startReplay", Qt::QueuedConnection);
+        return;
+    }
+
     if (mConectivity != SERIAL_ONLY)
     {
         qDebug("Started UDP server on port %d.", mPort);
-        mSocket.bind(QHostAddress::LocalHost, mPort);
+        int receiveBuffer = mConfiguration->getUdpReceiveBuffer();
+        if (mBulkSocket != nullptr)
+        {
+            ConfigLoadException::setContext("starting UDP server");
+            if (!mBulkSocket->bind(QHostAddress::LocalHost, mPort, receiveBuffer))
+            {
+                throw ConfigLoadException(QObject::tr("Failed to bind UDP port %1"), QString::number(mPort));
+            }
+        }
+        else
+        {
+            mSocket.bind(QHostAddress::LocalHost, mPort);
+            if (receiveBuffer > 0)
+            {
+                mSocket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, receiveBuffer);
+            }
+        }
     }
 
     if (mConectivity != UDP_ONLY)
@@ -166,6 +422,11 @@ void VisuServer::start()
             throw ConfigLoadException(QObject::tr("Setup of %1 failed"), serialPortName);
         }
 
+        if (mSerialProtocol == SERIAL_TEXT && mConfiguration->isSerialBindToSignal() && mSerialRegex.isValid())
+        {
+            setupSerialBindings();
+        }
+
         if (!mSerialPort->open(QIODevice::ReadWrite))
         {
             throw ConfigLoadException(QObject::tr("Failed to open port %1, error: %2")
@@ -189,76 +450,286 @@ void VisuServer::start()
             }
         }
     }
+
+    // Ports are opened in the calling thread, so setup errors can still be
+    // reported by exceptions. Reading is then handed over to ingest thread.
+    moveToThread(&mIngestThread);
+    mIngestThread.start();
 }
 
 void VisuServer::stop()
+{
+    if (mIngestThread.isRunning())
+    {
+        QMetaObject::invokeMethod(this, "closePorts", Qt::BlockingQueuedConnection);
+        mIngestThread.quit();
+        mIngestThread.wait();
+    }
+    else
+    {
+        closePorts();
+    }
+}
+
+/**
+ * @brief VisuServer::publishStats
+ * Publishes sequence statistics periodically, so that counts of last
+ * burst become visible even if no more packets arrive.
+ */
+void VisuServer::publishStats()
+{
+    mSequenceTracker.publish();
+}
+
+void VisuServer::closePorts()
 {
     QObject::disconnect(&mSocket, SIGNAL(readyRead()), this, SLOT(handleDatagram()));
-    QObject::disconnect(mSerialPort, SIGNAL(readyRead()), this, SLOT(handleSerial()));
-    QObject::disconnect(mSerialPort,
-            static_cast<void (QSerialPort::*)(QSerialPort::SerialPortError)>(&QSerialPort::error),
-            this,
-            &VisuServer::handleSerialError );
     QObject::disconnect(&mTimer, SIGNAL(timeout()), this, SLOT(pullSerial()));
+    mTimer.stop();
+    mReplayTimer.stop();
+    mReplay.close();
+    mRecorder.close();
+    mPublishTimer.stop();
+    mSequenceTracker.publish();
 
     mSocket.close();
 
-    mSerialPort->close();
-    delete mSerialPort;
+    if (mBulkSocket != nullptr)
+    {
+        QObject::disconnect(mBulkSocket, SIGNAL(readyRead()), this, SLOT(handleBulkDatagrams()));
+        mBulkSocket->close();
+    }
+
+    if (mSerialPort != nullptr)
+    {
+        QObject::disconnect(mSerialPort, SIGNAL(readyRead()), this, SLOT(handleSerial()));
+        QObject::disconnect(mSerialPort,
+                static_cast<void (QSerialPort::*)(QSerialPort::SerialPortError)>(&QSerialPort::error),
+                this,
+                &VisuServer::handleSerialError );
+        mSerialPort->close();
+        delete mSerialPort;
+        mSerialPort = nullptr;
+    }
 }
 
-VisuDatagram VisuServer::createDatagramFromBuffer(const quint8* buffer)
+/**
+ * @brief VisuServer::parseBatchFrame
+ * Validates frame checksum and decodes all records of the batched frame.
+ * Signals are updated only if whole frame is valid.
+ * @return true if frame was valid
+ */
+bool VisuServer::parseBatchFrame(const quint8* buffer, qint64 size, quint64 source)
 {
-    VisuDatagram datagram;
-
-    datagram.signalId = qFromBigEndian<quint16>((uchar*)buffer);
-    buffer += 2;
-
-    datagram.packetNumber = qFromBigEndian<quint16>((uchar*)buffer);
-    buffer += 2;
+    quint16 packetNumber;
+    int count = VisuWireCodec::decodeBatchHeader(buffer, size, packetNumber);
+    if (count < 0)
+    {
+        return false;
+    }
 
-    datagram.timestamp = qFromBigEndian<quint64>((uchar*)buffer);
-    buffer += 8;
+    // packet number belongs to frame, records are not judged one by one
+    if (!mSequenceTracker.acceptFrame(source, packetNumber, count))
+    {
+        return true;
+    }
 
-    datagram.rawValue = qFromBigEndian<quint64>((uchar*)buffer);
-    buffer += 8;
+    mBatch.resize(count);
+    VisuWireCodec::decodeRecords(buffer + VisuWireCodec::BATCH_HEADER_SIZE, count, packetNumber, mBatch.data());
+    for (const VisuDatagram& datagram : mBatch)
+    {
+        updateSignal(datagram);
+    }
+    return true;
+}
 
-    datagram.checksum = *buffer;
+void VisuServer::handleDatagramBuffer(const quint8* buffer, qint64 size, quint64 source)
+{
+    if (VisuWireCodec::isBatchFrame(buffer, size))
+    {
+        if (!parseBatchFrame(buffer, size, source))
+        {
+            mIngestQueue->countDrop();
+            qDebug("Bad batch package.");
+        }
+    }
+    else if (size >= VisuWireCodec::DATAGRAM_SIZE)
+    {
+        VisuDatagram datagram;
 
-    return datagram;
+        if (VisuWireCodec::decodeDatagram(buffer, datagram))
+        {
+            updateSequencedSignal(datagram);
+        }
+        else
+        {
+            mIngestQueue->countDrop();
+            qDebug("Bad package.");
+        }
+    }
+    else
+    {
+        mIngestQueue->countDrop();
+        qDebug("Bad package.");
+    }
 }
 
 void VisuServer::handleDatagram()
 {
-    QByteArray buffer(DATAGRAM_SIZE, 0);
-    char* bufferRawData = (char*)buffer.data();
-    QHostAddress senderAddress;
-    quint16 senderPort;
-
     while(mSocket.hasPendingDatagrams())
     {
-        mSocket.readDatagram(bufferRawData, DATAGRAM_SIZE, &senderAddress, &senderPort);
-        VisuDatagram datagram = createDatagramFromBuffer((const quint8*)bufferRawData);
-
-        if (datagram.checksumOk())
+        // buffer is kept between calls, so it is only reallocated on growth
+        qint64 pendingSize = qMax<qint64>(mSocket.pendingDatagramSize(), VisuWireCodec::DATAGRAM_SIZE);
+        if (mDatagramBuffer.size() < pendingSize)
         {
-            updateSignal(datagram);
+            mDatagramBuffer.resize(pendingSize);
         }
-        else
+        QHostAddress address;
+        quint16 port;
+        qint64 size = mSocket.readDatagram(mDatagramBuffer.data(), mDatagramBuffer.size(), &address, &port);
+        stampReceived();
+        quint64 source = ((quint64)address.toIPv4Address() << 16) | port;
+        handleDatagramBuffer((const quint8*)mDatagramBuffer.constData(), size, source);
+    }
+}
+
+/**
+ * @brief VisuServer::handleBulkDatagrams
+ * Drains bulk socket, batch by batch, until it runs out of datagrams.
+ */
+void VisuServer::handleBulkDatagrams()
+{
+    int count;
+    do
+    {
+        count = mBulkSocket->receive();
+        stampReceived();
+        for (int i = 0; i < count; ++i)
         {
-            qDebug("Bad UDP package.");
+            if (mBulkSocket->isTruncated(i))
+            {
+                mIngestQueue->countDrop();
+                qDebug("Truncated UDP package.");
+            }
+            else
+            {
+                handleDatagramBuffer(mBulkSocket->datagramData(i),
+                                     mBulkSocket->datagramSize(i),
+                                     mBulkSocket->datagramSource(i));
+            }
         }
-    }
+    } while (count == mBulkSocket->getBatchSize());
 }
 
+/**
+ * @brief VisuServer::updateSignal
+ * Called in ingest thread. Signals are owned by GUI thread, so datagram
+ * is only queued here and delivered when GUI thread drains the queue.
+ */
 void VisuServer::updateSignal(const VisuDatagram& datagram)
 {
-    VisuSignal* signal = mConfiguration->getSignal(datagram.signalId);
-    if (signal != nullptr) {
-        signal->datagramUpdate(datagram);
+    if (mRecorder.isOpen())
+    {
+        mRecorder.record(datagram);
+    }
+
+    if (VisuLatencyTracer::isEnabled())
+    {
+        VisuDatagram traced = datagram;
+        traced.traceReceived = mTraceReceived;
+        traced.traceDecoded = VisuLatencyTracer::now();
+        mIngestQueue->push(traced);
+        return;
+    }
+
+    mIngestQueue->push(datagram);
+}
+
+/**
+ * @brief VisuServer::stampReceived
+ * Marks arrival of data read from socket or port, for latency tracing.
+ */
+void VisuServer::stampReceived()
+{
+    if (VisuLatencyTracer::isEnabled())
+    {
+        mTraceReceived = VisuLatencyTracer::now();
     }
 }
 
+/**
+ * @brief VisuServer::updateSequencedSignal
+ * Updates signal with datagram carrying packet number, unless it is
+ * stale and stale samples are dropped.
+ */
+void VisuServer::updateSequencedSignal(const VisuDatagram& datagram)
+{
+    if (mSequenceTracker.accept(datagram.signalId, datagram.packetNumber))
+    {
+        updateSignal(datagram);
+    }
+}
+
+/**
+ * @brief VisuServer::startReplay
+ * Called in ingest thread. Paced replay polls every millisecond, maximum
+ * speed replay runs whenever ingest thread is idle.
+ */
+void VisuServer::startReplay()
+{
+    qDebug("Replaying %d datagrams at %s speed.",
+           mReplay.getCount(),
+           mReplaySpeed > 0 ? QString("%1x").arg(mReplaySpeed).toStdString().c_str() : "maximum");
+
+    mReplayPosition = 0;
+    mReplayBase = mReplay.getCount() > 0 ? mReplay.getArrival(0) : 0;
+    mReplayTimer.setTimerType(Qt::PreciseTimer);
+    mReplayTimer.setInterval(mReplaySpeed > 0 ? 1 : 0);
+    mReplayClock.start();
+    mReplayTimer.start();
+}
+
+/**
+ * @brief VisuServer::replayNext
+ * Passes recorded datagrams to updateSignal. Paced replay passes those
+ * whose arrival, scaled by speed, is due. Maximum speed replay passes as
+ * many as ingest queue has room for, so that nothing is lost to overruns
+ * and run over the same log is repeatable. Either way at most one queue
+ * worth is passed per call, to keep ingest thread responsive.
+ */
+void VisuServer::replayNext()
+{
+    int count = mReplay.getCount();
+    int budget = mReplaySpeed > 0 ? VisuIngestQueue::DEFAULT_CAPACITY : mIngestQueue->getFree();
+    quint64 due = mReplayBase + (quint64)(mReplayClock.nsecsElapsed() * mReplaySpeed);
+    stampReceived();
+
+    while (budget-- > 0 && mReplayPosition < count)
+    {
+        if (mReplaySpeed > 0 && mReplay.getArrival(mReplayPosition) > due)
+        {
+            break;
+        }
+        updateSignal(mReplay.getDatagram(mReplayPosition++));
+    }
+
+    if (mReplayPosition == count)
+    {
+        finishReplay();
+    }
+}
+
+void VisuServer::finishReplay()
+{
+    mReplayTimer.stop();
+
+    qint64 elapsed = qMax<qint64>(mReplayClock.elapsed(), 1);
+    qDebug("Replay of %d datagrams finished in %lld ms, %.0f datagrams/s.",
+           mReplay.getCount(),
+           elapsed,
+           mReplay.getCount() * 1000.0 / elapsed);
+}
+
 void VisuServer::pullSerial()
 {
     sendSerial(mConfiguration->getSerialPullString().toLocal8Bit());
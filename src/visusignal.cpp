@@ -5,14 +5,16 @@ const QString VisuSignal::TAG_NAME = "signal";
 VisuSignal::VisuSignal(const QMap<QString, QString>& properties)
 {
     mProperties = properties;
-    mPropertiesMeta = VisuConfigLoader::getMetaMapFromFile( VisuSignal::TAG_NAME,
-                                                            VisuSignal::TAG_NAME);
+    mPropertiesMeta = VisuConfigLoader::getMetaMap(VisuSignal::TAG_NAME,
+                                                   VisuSignal::TAG_NAME);
+    mProperties.setSchema(VisuPropertySchema::compile(VisuSignal::TAG_NAME, mPropertiesMeta));
+    mTrace = VisuTraceSample();
     load();
 }
 
 const QMap<QString, QString>& VisuSignal::getProperties()
 {
-    return mProperties;
+    return mProperties.map();
 }
 
 /**
@@ -66,7 +68,7 @@ quint16 VisuSignal::getId() const
 void VisuSignal::setId(quint16 id)
 {
     cId = id;
-    mProperties["id"] = QString("%1").arg(id);
+    mProperties.set("id", QString("%1").arg(id));
 }
 
 /**
@@ -106,16 +108,38 @@ double VisuSignal::getOffset() const
  */
 double VisuSignal::getRealValue() const
 {
-    return mRawValue * cFactor + cOffset;
+    return rawToReal(mRawValue);
+}
+
+/**
+ * @brief VisuSignal::rawToReal
+ * Converts raw value, e.g. one taken from history, to real value.
+ * @param rawValue
+ * @return
+ */
+double VisuSignal::rawToReal(quint64 rawValue) const
+{
+    return rawValue * cFactor + cOffset;
 }
 
 double VisuSignal::getNormalizedValue() const
 {
-    double value = (getRealValue() - cMin) / (cMax - cMin);
+    return normalize(getRealValue());
+}
+
+/**
+ * @brief VisuSignal::normalize
+ * Maps real value to [0, 1] range, based on signal minimum and maximum.
+ * @param realValue
+ * @return
+ */
+double VisuSignal::normalize(double realValue) const
+{
+    double value = (realValue - cMin) / (cMax - cMin);
     if (value < 0.0 || value > 1.0)
     {
         value = 0.0;
-        qDebug("Signal id=%d outside of range (min=%f, max=%f, received=%f.", cId, cMin, cMax, getRealValue());
+        qDebug("Signal id=%d outside of range (min=%f, max=%f, received=%f.", cId, cMin, cMax, realValue);
     }
     return value;
 }
@@ -129,6 +153,15 @@ void VisuSignal::datagramUpdate(const VisuDatagram& datagram)
 
     mRawValue = datagram.rawValue;
     mTimestamp = datagram.timestamp;
+    mHistory.append(mTimestamp, mRawValue);
+
+    if (VisuLatencyTracer::isEnabled())
+    {
+        mTrace.received = datagram.traceReceived;
+        mTrace.decoded = datagram.traceDecoded;
+        mTrace.updated = VisuLatencyTracer::now();
+        mTrace.signalId = cId;
+    }
 
     notifyInstruments();
 }
@@ -171,6 +204,28 @@ quint64 VisuSignal::getTimestamp() const
     return mTimestamp;
 }
 
+/**
+ * @brief VisuSignal::getHistory
+ * Returns recently received samples. Range queries on history point
+ * directly into its buffer, so no samples are copied.
+ * @return
+ */
+const VisuSignalHistory& VisuSignal::getHistory() const
+{
+    return mHistory;
+}
+
+/**
+ * @brief VisuSignal::getTrace
+ * Trace stamps of last received value. Valid only while latency tracing
+ * is enabled, updated is 0 until first value is received.
+ * @return
+ */
+const VisuTraceSample& VisuSignal::getTrace() const
+{
+    return mTrace;
+}
+
 int VisuSignal::getSerialPlaceholder() const
 {
     return cSerialPlaceholder;
@@ -190,24 +245,31 @@ const QMap<QString, VisuPropertyMeta>& VisuSignal::getPropertiesMeta()
 void VisuSignal::setPropertiesMeta(const QMap<QString, VisuPropertyMeta>& meta)
 {
     mPropertiesMeta = meta;
+    mProperties.setSchema(VisuPropertySchema::compile(VisuSignal::TAG_NAME, mPropertiesMeta));
 }
 
 
 void VisuSignal::updateProperty(QString key, QString value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     load();
 }
 
 void VisuSignal::load()
 {
-    GET_PROPERTY(cId, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cName, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cUnit, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cFactor, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cOffset, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMax, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cMin, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cSerialPlaceholder, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cSerialTransform, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cId, mProperties);
+    GET_PROPERTY(cName, mProperties);
+    GET_PROPERTY(cUnit, mProperties);
+    GET_PROPERTY(cFactor, mProperties);
+    GET_PROPERTY(cOffset, mProperties);
+    GET_PROPERTY(cMax, mProperties);
+    GET_PROPERTY(cMin, mProperties);
+    GET_PROPERTY(cSerialPlaceholder, mProperties);
+    GET_PROPERTY(cSerialTransform, mProperties);
+    GET_PROPERTY(cHistorySize, mProperties);
+
+    if (mHistory.capacity() != (int)cHistorySize)
+    {
+        mHistory.setCapacity(cHistorySize);
+    }
 }
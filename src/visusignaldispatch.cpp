@@ -0,0 +1,49 @@
+#include "visusignaldispatch.h"
+#include "visusignal.h"
+
+VisuSignalDispatch::VisuSignalDispatch() : mPages(PAGE_COUNT)
+{
+}
+
+/**
+ * @brief VisuSignalDispatch::VisuSignalDispatch
+ * Builds table from signals of configuration, keyed by their own ids.
+ * If two signals share an id, the first one is kept.
+ * @param signalsList
+ */
+VisuSignalDispatch::VisuSignalDispatch(const QVector<QPointer<VisuSignal>>& signalsList) : mPages(PAGE_COUNT)
+{
+    for (VisuSignal* signal : signalsList)
+    {
+        if (signal == nullptr)
+        {
+            continue;
+        }
+
+        quint16 id = signal->getId();
+        QVector<Entry>& page = mPages[id >> PAGE_BITS];
+        if (page.isEmpty())
+        {
+            page = QVector<Entry>(PAGE_SIZE, Entry());
+        }
+
+        Entry& entry = page[id & PAGE_MASK];
+        if (entry.signal != nullptr)
+        {
+            qDebug("Duplicate signal id %d, signal \"%s\" is ignored.", id, signal->getName().toStdString().c_str());
+            continue;
+        }
+
+        entry.signal = signal;
+        entry.factor = signal->getFactor();
+        entry.offset = signal->getOffset();
+        entry.serialPlaceholder = signal->getSerialPlaceholder();
+        entry.serialTransform = signal->getSerialTransform();
+        mIds.append(id);
+    }
+}
+
+const QVector<quint16>& VisuSignalDispatch::getIds() const
+{
+    return mIds;
+}
@@ -0,0 +1,189 @@
+#include "visusignalhistory.h"
+
+int VisuSignalHistory::Range::size() const
+{
+    return first.size + second.size;
+}
+
+quint64 VisuSignalHistory::Range::timestampAt(int index) const
+{
+    return index < first.size ? first.timestamps[index] : second.timestamps[index - first.size];
+}
+
+quint64 VisuSignalHistory::Range::rawValueAt(int index) const
+{
+    return index < first.size ? first.rawValues[index] : second.rawValues[index - first.size];
+}
+
+VisuSignalHistory::VisuSignalHistory() : mCapacity(0),
+                                         mHead(0),
+                                         mSize(0),
+                                         mAppended(0)
+{
+}
+
+/**
+ * @brief VisuSignalHistory::setCapacity
+ * Reallocates the buffer. Stored samples are discarded.
+ * @param capacity
+ */
+void VisuSignalHistory::setCapacity(int capacity)
+{
+    mCapacity = qMax(0, capacity);
+    mTimestamps = QVector<quint64>(mCapacity);
+    mRawValues = QVector<quint64>(mCapacity);
+    clear();
+}
+
+int VisuSignalHistory::capacity() const
+{
+    return mCapacity;
+}
+
+int VisuSignalHistory::size() const
+{
+    return mSize;
+}
+
+bool VisuSignalHistory::isEmpty() const
+{
+    return mSize == 0;
+}
+
+void VisuSignalHistory::clear()
+{
+    mHead = 0;
+    mSize = 0;
+}
+
+quint64 VisuSignalHistory::appended() const
+{
+    return mAppended;
+}
+
+void VisuSignalHistory::append(quint64 timestamp, quint64 rawValue)
+{
+    if (mCapacity == 0)
+    {
+        return;
+    }
+
+    if (mSize > 0)
+    {
+        timestamp = qMax(timestamp, mTimestamps[physicalIndex(mSize - 1)]);
+    }
+
+    int tail = physicalIndex(mSize == mCapacity ? 0 : mSize);
+    mTimestamps[tail] = timestamp;
+    mRawValues[tail] = rawValue;
+
+    if (mSize == mCapacity)
+    {
+        mHead = (mHead + 1 == mCapacity) ? 0 : mHead + 1;
+    }
+    else
+    {
+        ++mSize;
+    }
+
+    ++mAppended;
+}
+
+int VisuSignalHistory::physicalIndex(int logical) const
+{
+    int index = mHead + logical;
+    return index >= mCapacity ? index - mCapacity : index;
+}
+
+VisuSignalHistory::Range VisuSignalHistory::logicalRange(int begin, int end) const
+{
+    Range range;
+    range.first = {mTimestamps.constData(), mRawValues.constData(), 0};
+    range.second = range.first;
+
+    if (begin >= end)
+    {
+        return range;
+    }
+
+    int physicalBegin = physicalIndex(begin);
+    int firstSize = qMin(end - begin, mCapacity - physicalBegin);
+
+    range.first.timestamps += physicalBegin;
+    range.first.rawValues += physicalBegin;
+    range.first.size = firstSize;
+    range.second.size = end - begin - firstSize;   // wrapped part starts at index 0
+
+    return range;
+}
+
+VisuSignalHistory::Range VisuSignalHistory::all() const
+{
+    return logicalRange(0, mSize);
+}
+
+VisuSignalHistory::Range VisuSignalHistory::last(int count) const
+{
+    return logicalRange(mSize - qBound(0, count, mSize), mSize);
+}
+
+/**
+ * @brief VisuSignalHistory::since
+ * Returns samples appended after sample with given sequence number. If
+ * some of them were already overwritten, only the remaining ones are
+ * returned.
+ */
+VisuSignalHistory::Range VisuSignalHistory::since(quint64 sequence) const
+{
+    quint64 newer = mAppended > sequence ? mAppended - sequence : 0;
+    return last((int)qMin<quint64>(newer, mSize));
+}
+
+// append() keeps the logical sequence sorted by timestamp, which allows
+// binary search.
+int VisuSignalHistory::lowerBound(quint64 timestamp) const
+{
+    int low = 0;
+    int high = mSize;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (mTimestamps[physicalIndex(mid)] < timestamp)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+int VisuSignalHistory::upperBound(quint64 timestamp) const
+{
+    int low = 0;
+    int high = mSize;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (mTimestamps[physicalIndex(mid)] <= timestamp)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief VisuSignalHistory::window
+ * Returns samples with timestamp in [from, to] interval.
+ */
+VisuSignalHistory::Range VisuSignalHistory::window(quint64 from, quint64 to) const
+{
+    return logicalRange(lowerBound(from), upperBound(to));
+}
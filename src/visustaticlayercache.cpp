@@ -0,0 +1,66 @@
+#include "visustaticlayercache.h"
+
+VisuStaticLayerCache* VisuStaticLayerCache::instance = nullptr;
+
+VisuStaticLayerCache* VisuStaticLayerCache::get()
+{
+    if (instance == nullptr)
+    {
+        instance = new VisuStaticLayerCache();
+    }
+    return instance;
+}
+
+VisuStaticLayerCache::VisuStaticLayerCache() : mLayersShared(0)
+{
+}
+
+/**
+ * @brief VisuStaticLayerCache::find
+ * Assigns cached layer, so layer shares its data with every instrument
+ * that rendered or found the same one.
+ * @return false if no layer is cached under key
+ */
+bool VisuStaticLayerCache::find(const QByteArray& key, VisuLayer& layer)
+{
+    auto itr = mLayers.constFind(key);
+    if (itr == mLayers.constEnd())
+    {
+        return false;
+    }
+
+    layer = itr.value();
+    ++mLayersShared;
+    return true;
+}
+
+void VisuStaticLayerCache::insert(const QByteArray& key, const VisuLayer& layer)
+{
+    prune();
+    mLayers.insert(key, layer);
+}
+
+quint64 VisuStaticLayerCache::getLayersShared() const
+{
+    return mLayersShared;
+}
+
+/**
+ * @brief VisuStaticLayerCache::prune
+ * Drops layers only referenced by cache, whose instruments were either
+ * destroyed or rendered different static layer since.
+ */
+void VisuStaticLayerCache::prune()
+{
+    for (auto itr = mLayers.begin(); itr != mLayers.end();)
+    {
+        if (itr.value().isDetached())
+        {
+            itr = mLayers.erase(itr);
+        }
+        else
+        {
+            ++itr;
+        }
+    }
+}
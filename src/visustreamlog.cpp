@@ -0,0 +1,190 @@
+#include "visustreamlog.h"
+#include <QDateTime>
+#include <qendian.h>
+
+VisuStreamRecorder::VisuStreamRecorder() : mRecorded(0)
+{
+}
+
+VisuStreamRecorder::~VisuStreamRecorder()
+{
+    close();
+}
+
+/**
+ * @brief VisuStreamRecorder::open
+ * Creates log at path, overwriting existing file, and writes its header.
+ * Arrival times of records are measured from this moment.
+ * @return false if file could not be created
+ */
+bool VisuStreamRecorder::open(const QString& path)
+{
+    close();
+
+    mFile.setFileName(path);
+    if (!mFile.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        return false;
+    }
+
+    uchar header[VisuStreamLog::HEADER_SIZE];
+    qToLittleEndian<quint32>(VisuStreamLog::MAGIC, header);
+    qToLittleEndian<quint16>(VisuStreamLog::VERSION, header + 4);
+    qToLittleEndian<quint16>(VisuStreamLog::RECORD_SIZE, header + 6);
+    qToLittleEndian<quint64>(QDateTime::currentMSecsSinceEpoch(), header + 8);
+    mFile.write((const char*)header, sizeof(header));
+
+    mBuffer.reserve(FLUSH_SIZE + VisuStreamLog::RECORD_SIZE);
+    mBuffer.resize(0);
+    mRecorded = 0;
+    mClock.start();
+    return true;
+}
+
+bool VisuStreamRecorder::isOpen() const
+{
+    return mFile.isOpen();
+}
+
+void VisuStreamRecorder::record(const VisuDatagram& datagram)
+{
+    int offset = mBuffer.size();
+    mBuffer.resize(offset + VisuStreamLog::RECORD_SIZE);
+    uchar* out = (uchar*)mBuffer.data() + offset;
+
+    qToLittleEndian<quint64>(mClock.nsecsElapsed(), out);
+    qToLittleEndian<quint64>(datagram.timestamp, out + 8);
+    qToLittleEndian<quint64>(datagram.rawValue, out + 16);
+    qToLittleEndian<quint16>(datagram.signalId, out + 24);
+    qToLittleEndian<quint16>(datagram.packetNumber, out + 26);
+    ++mRecorded;
+
+    if (mBuffer.size() >= FLUSH_SIZE)
+    {
+        flush();
+    }
+}
+
+void VisuStreamRecorder::record(const VisuDatagram* datagrams, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        record(datagrams[i]);
+    }
+}
+
+void VisuStreamRecorder::flush()
+{
+    if (mFile.isOpen() && !mBuffer.isEmpty())
+    {
+        mFile.write(mBuffer);
+        mBuffer.resize(0);
+    }
+}
+
+void VisuStreamRecorder::close()
+{
+    if (mFile.isOpen())
+    {
+        flush();
+        mFile.close();
+        qDebug("Recorded %llu datagrams to %s.", mRecorded, mFile.fileName().toStdString().c_str());
+    }
+}
+
+quint64 VisuStreamRecorder::getRecorded() const
+{
+    return mRecorded;
+}
+
+VisuStreamReplay::VisuStreamReplay() : mData(nullptr), mCount(0)
+{
+}
+
+VisuStreamReplay::~VisuStreamReplay()
+{
+    close();
+}
+
+/**
+ * @brief VisuStreamReplay::open
+ * Maps log at path and checks its header. Incomplete last record is
+ * ignored.
+ * @return false if file can not be read or is not a stream log
+ */
+bool VisuStreamReplay::open(const QString& path)
+{
+    close();
+
+    mFile.setFileName(path);
+    if (!mFile.open(QFile::ReadOnly) || mFile.size() < VisuStreamLog::HEADER_SIZE)
+    {
+        return false;
+    }
+
+    const uchar* data = mFile.map(0, mFile.size());
+    if (data == nullptr
+        || qFromLittleEndian<quint32>(data) != VisuStreamLog::MAGIC
+        || qFromLittleEndian<quint16>(data + 4) != VisuStreamLog::VERSION
+        || qFromLittleEndian<quint16>(data + 6) != VisuStreamLog::RECORD_SIZE)
+    {
+        if (data != nullptr)
+        {
+            mFile.unmap(const_cast<uchar*>(data));
+        }
+        mFile.close();
+        return false;
+    }
+
+    mData = data;
+    mCount = (int)((mFile.size() - VisuStreamLog::HEADER_SIZE) / VisuStreamLog::RECORD_SIZE);
+    return true;
+}
+
+void VisuStreamReplay::close()
+{
+    if (mData != nullptr)
+    {
+        mFile.unmap(const_cast<uchar*>(mData));
+        mData = nullptr;
+    }
+    mFile.close();
+    mCount = 0;
+}
+
+int VisuStreamReplay::getCount() const
+{
+    return mCount;
+}
+
+quint64 VisuStreamReplay::getStartTime() const
+{
+    return qFromLittleEndian<quint64>(mData + 8);
+}
+
+const uchar* VisuStreamReplay::recordAt(int index) const
+{
+    return mData + VisuStreamLog::HEADER_SIZE + (qint64)index * VisuStreamLog::RECORD_SIZE;
+}
+
+/**
+ * @brief VisuStreamReplay::getArrival
+ * Arrival of record, in nanoseconds since recording was started.
+ */
+quint64 VisuStreamReplay::getArrival(int index) const
+{
+    return qFromLittleEndian<quint64>(recordAt(index));
+}
+
+VisuDatagram VisuStreamReplay::getDatagram(int index) const
+{
+    const uchar* record = recordAt(index);
+
+    VisuDatagram datagram;
+    datagram.timestamp = qFromLittleEndian<quint64>(record + 8);
+    datagram.rawValue = qFromLittleEndian<quint64>(record + 16);
+    datagram.signalId = qFromLittleEndian<quint16>(record + 24);
+    datagram.packetNumber = qFromLittleEndian<quint16>(record + 26);
+    datagram.checksum = 0x0;
+    return datagram;
+}
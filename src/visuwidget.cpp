@@ -97,21 +97,21 @@ void VisuWidget::drawActiveBox(QPainter* painter)
 
 bool VisuWidget::updateProperties(const QString& key, const QString& value)
 {
-    mProperties[key] = value;
+    mProperties.set(key, value);
     VisuWidget::loadProperties();
     return VisuWidget::refresh(key);
 }
 
 void VisuWidget::loadProperties()
 {
-    ConfigLoadException::setInstrumentLoadContext(mProperties);
+    ConfigLoadException::setInstrumentLoadContext(mProperties.map());
 
-    GET_PROPERTY(cId, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cName, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cX, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cY, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cWidth, mProperties, mPropertiesMeta);
-    GET_PROPERTY(cHeight, mProperties, mPropertiesMeta);
+    GET_PROPERTY(cId, mProperties);
+    GET_PROPERTY(cName, mProperties);
+    GET_PROPERTY(cX, mProperties);
+    GET_PROPERTY(cY, mProperties);
+    GET_PROPERTY(cWidth, mProperties);
+    GET_PROPERTY(cHeight, mProperties);
 
     setup();
 }
@@ -131,17 +131,18 @@ quint16 VisuWidget::getId() const
 void VisuWidget::setId(quint16 id)
 {
     cId = id;
-    mProperties[VisuWidget::KEY_ID] = QString("%1").arg(id);
+    mProperties.set(VisuWidget::KEY_ID, QString("%1").arg(id));
 }
 
-QMap<QString, QString>& VisuWidget::getProperties()
+const QMap<QString, QString>& VisuWidget::getProperties() const
 {
-    return mProperties;
+    return mProperties.map();
 }
 
 void VisuWidget::setPropertiesMeta(QMap<QString, VisuPropertyMeta> meta)
 {
     mPropertiesMeta = meta;
+    mProperties.setSchema(VisuPropertySchema::compile(mProperties.value(KEY_TYPE), mPropertiesMeta));
 }
 
 QMap<QString, VisuPropertyMeta> VisuWidget::getPropertiesMeta()
@@ -164,8 +165,8 @@ void VisuWidget::setPosition(QPoint position)
     cX = position.x();
     cY = position.y();
     setGeometry(cX, cY, cWidth, cHeight);
-    mProperties[VisuWidget::KEY_X] = QString("%1").arg(cX);
-    mProperties[VisuWidget::KEY_Y] = QString("%1").arg(cY);
+    mProperties.set(VisuWidget::KEY_X, QString("%1").arg(cX));
+    mProperties.set(VisuWidget::KEY_Y, QString("%1").arg(cY));
 }
 
 const QSize VisuWidget::sizeHint()
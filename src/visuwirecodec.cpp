@@ -0,0 +1,503 @@
+#include "visuwirecodec.h"
+#include <qendian.h>
+#include <QByteArray>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define VISU_WIRE_X86
+#include <immintrin.h>
+#endif
+
+// timestamp and raw value are converted together, as one 16 byte block
+static_assert(offsetof(VisuDatagram, rawValue) == offsetof(VisuDatagram, timestamp) + 8,
+              "timestamp and raw value have to be adjacent");
+
+namespace
+{
+    const int DATAGRAM_VALUES_OFFSET = 4;   // timestamp and raw value
+    const int RECORD_VALUES_OFFSET = 2;
+    const int DATAGRAM_CHECKSUM_OFFSET = 20;
+    const int TEXT_FIELD_COUNT = 5;
+    const quint8 COBS_MAX_CODE = 0xFF;
+
+    struct Implementation
+    {
+        const char* name;
+        quint8 (*xorChecksum)(const quint8* data, qint64 size);
+        bool (*decodeDatagram)(const quint8* wire, VisuDatagram& datagram);
+        void (*decodeRecords)(const quint8* records, int count, quint16 packetNumber, VisuDatagram* datagrams);
+    };
+
+    quint8 xorScalar(const quint8* data, qint64 size)
+    {
+        quint64 sum = 0;
+        qint64 i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            quint64 word;
+            memcpy(&word, data + i, sizeof(word));
+            sum ^= word;
+        }
+        sum ^= sum >> 32;
+        sum ^= sum >> 16;
+        sum ^= sum >> 8;
+
+        quint8 result = (quint8)sum;
+        for (; i < size; ++i)
+        {
+            result ^= data[i];
+        }
+        return result;
+    }
+
+    bool decodeDatagramScalar(const quint8* wire, VisuDatagram& datagram)
+    {
+        datagram.signalId = qFromBigEndian<quint16>(wire);
+        datagram.packetNumber = qFromBigEndian<quint16>(wire + 2);
+        datagram.timestamp = qFromBigEndian<quint64>(wire + DATAGRAM_VALUES_OFFSET);
+        datagram.rawValue = qFromBigEndian<quint64>(wire + DATAGRAM_VALUES_OFFSET + 8);
+        datagram.checksum = wire[DATAGRAM_CHECKSUM_OFFSET];
+        return xorScalar(wire, DATAGRAM_CHECKSUM_OFFSET) == datagram.checksum;
+    }
+
+    void decodeRecordsScalar(const quint8* records, int count, quint16 packetNumber, VisuDatagram* datagrams)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const quint8* record = records + i * VisuWireCodec::RECORD_SIZE;
+            datagrams[i].signalId = qFromBigEndian<quint16>(record);
+            datagrams[i].packetNumber = packetNumber;
+            datagrams[i].timestamp = qFromBigEndian<quint64>(record + RECORD_VALUES_OFFSET);
+            datagrams[i].rawValue = qFromBigEndian<quint64>(record + RECORD_VALUES_OFFSET + 8);
+            datagrams[i].checksum = 0x0;
+        }
+    }
+
+#ifdef VISU_WIRE_X86
+    // reverses bytes within each 64 bit lane, using SSE2 only
+    inline __m128i swapQuadsSse2(__m128i value)
+    {
+        value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+        return _mm_shufflehi_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+
+    inline quint8 foldXor(__m128i value)
+    {
+        value = _mm_xor_si128(value, _mm_srli_si128(value, 8));
+        value = _mm_xor_si128(value, _mm_srli_si128(value, 4));
+        value = _mm_xor_si128(value, _mm_srli_si128(value, 2));
+        value = _mm_xor_si128(value, _mm_srli_si128(value, 1));
+        return (quint8)_mm_cvtsi128_si32(value);
+    }
+
+    quint8 xorSse2(const quint8* data, qint64 size)
+    {
+        __m128i sum = _mm_setzero_si128();
+        qint64 i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            sum = _mm_xor_si128(sum, _mm_loadu_si128((const __m128i*)(data + i)));
+        }
+        return foldXor(sum) ^ xorScalar(data + i, size - i);
+    }
+
+    inline void storeValues(VisuDatagram& datagram, __m128i values)
+    {
+        _mm_storeu_si128((__m128i*)&datagram.timestamp, values);
+    }
+
+    bool decodeDatagramSse2(const quint8* wire, VisuDatagram& datagram)
+    {
+        __m128i head = _mm_loadu_si128((const __m128i*)wire);
+        __m128i values = _mm_loadu_si128((const __m128i*)(wire + DATAGRAM_VALUES_OFFSET));
+
+        datagram.signalId = qFromBigEndian<quint16>(wire);
+        datagram.packetNumber = qFromBigEndian<quint16>(wire + 2);
+        storeValues(datagram, swapQuadsSse2(values));
+        datagram.checksum = wire[DATAGRAM_CHECKSUM_OFFSET];
+
+        quint8 sum = foldXor(head) ^ wire[16] ^ wire[17] ^ wire[18] ^ wire[19];
+        return sum == datagram.checksum;
+    }
+
+    void decodeRecordsSse2(const quint8* records, int count, quint16 packetNumber, VisuDatagram* datagrams)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const quint8* record = records + i * VisuWireCodec::RECORD_SIZE;
+            __m128i values = _mm_loadu_si128((const __m128i*)(record + RECORD_VALUES_OFFSET));
+            storeValues(datagrams[i], swapQuadsSse2(values));
+            datagrams[i].signalId = qFromBigEndian<quint16>(record);
+            datagrams[i].packetNumber = packetNumber;
+            datagrams[i].checksum = 0x0;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    quint8 xorAvx2(const quint8* data, qint64 size)
+    {
+        __m256i wide = _mm256_setzero_si256();
+        qint64 i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            wide = _mm256_xor_si256(wide, _mm256_loadu_si256((const __m256i*)(data + i)));
+        }
+
+        __m128i sum = _mm_xor_si128(_mm256_castsi256_si128(wide), _mm256_extracti128_si256(wide, 1));
+        if (i + 16 <= size)
+        {
+            sum = _mm_xor_si128(sum, _mm_loadu_si128((const __m128i*)(data + i)));
+            i += 16;
+        }
+        return foldXor(sum) ^ xorScalar(data + i, size - i);
+    }
+
+    __attribute__((target("avx2")))
+    bool decodeDatagramAvx2(const quint8* wire, VisuDatagram& datagram)
+    {
+        const __m128i swapMask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        __m128i head = _mm_loadu_si128((const __m128i*)wire);
+        __m128i values = _mm_loadu_si128((const __m128i*)(wire + DATAGRAM_VALUES_OFFSET));
+
+        datagram.signalId = qFromBigEndian<quint16>(wire);
+        datagram.packetNumber = qFromBigEndian<quint16>(wire + 2);
+        storeValues(datagram, _mm_shuffle_epi8(values, swapMask));
+        datagram.checksum = wire[DATAGRAM_CHECKSUM_OFFSET];
+
+        quint8 sum = foldXor(head) ^ wire[16] ^ wire[17] ^ wire[18] ^ wire[19];
+        return sum == datagram.checksum;
+    }
+
+    // two records per iteration, one in each 128 bit lane
+    __attribute__((target("avx2")))
+    void decodeRecordsAvx2(const quint8* records, int count, quint16 packetNumber, VisuDatagram* datagrams)
+    {
+        const __m256i swapMask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                                  7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        int i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            const quint8* first = records + i * VisuWireCodec::RECORD_SIZE;
+            const quint8* second = first + VisuWireCodec::RECORD_SIZE;
+
+            __m256i values = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(first + RECORD_VALUES_OFFSET)));
+            values = _mm256_inserti128_si256(values, _mm_loadu_si128((const __m128i*)(second + RECORD_VALUES_OFFSET)), 1);
+            values = _mm256_shuffle_epi8(values, swapMask);
+
+            storeValues(datagrams[i], _mm256_castsi256_si128(values));
+            storeValues(datagrams[i + 1], _mm256_extracti128_si256(values, 1));
+            datagrams[i].signalId = qFromBigEndian<quint16>(first);
+            datagrams[i + 1].signalId = qFromBigEndian<quint16>(second);
+            datagrams[i].packetNumber = packetNumber;
+            datagrams[i + 1].packetNumber = packetNumber;
+            datagrams[i].checksum = 0x0;
+            datagrams[i + 1].checksum = 0x0;
+        }
+
+        decodeRecordsSse2(records + i * VisuWireCodec::RECORD_SIZE, count - i, packetNumber, datagrams + i);
+    }
+#endif
+
+    const Implementation SCALAR = { "scalar", xorScalar, decodeDatagramScalar, decodeRecordsScalar };
+#ifdef VISU_WIRE_X86
+    const Implementation SSE2 = { "SSE2", xorSse2, decodeDatagramSse2, decodeRecordsSse2 };
+    const Implementation AVX2 = { "AVX2", xorAvx2, decodeDatagramAvx2, decodeRecordsAvx2 };
+#endif
+
+    // VISU_WIRE_CODEC=scalar forces scalar implementation, e.g. to compare
+    // implementations in benchmark
+    Implementation selectImplementation()
+    {
+        if (qgetenv("VISU_WIRE_CODEC") == "scalar")
+        {
+            return SCALAR;
+        }
+#ifdef VISU_WIRE_X86
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return AVX2;
+        }
+        return SSE2;
+#else
+        return SCALAR;
+#endif
+    }
+
+    Implementation& implementation()
+    {
+        static Implementation selected = selectImplementation();
+        return selected;
+    }
+}
+
+namespace VisuWireCodec
+{
+    /**
+     * @brief xorChecksum
+     * Returns XOR of all bytes in buffer.
+     */
+    quint8 xorChecksum(const quint8* data, qint64 size)
+    {
+        return implementation().xorChecksum(data, size);
+    }
+
+    /**
+     * @brief decodeDatagram
+     * Decodes single datagram of DATAGRAM_SIZE bytes.
+     * @return true if checksum over wire bytes matches
+     */
+    bool decodeDatagram(const quint8* wire, VisuDatagram& datagram)
+    {
+        return implementation().decodeDatagram(wire, datagram);
+    }
+
+    /**
+     * @brief decodeRecords
+     * Decodes records of batched frame. Frame checksum is not verified
+     * here, see xorChecksum.
+     */
+    void decodeRecords(const quint8* records, int count, quint16 packetNumber, VisuDatagram* datagrams)
+    {
+        implementation().decodeRecords(records, count, packetNumber, datagrams);
+    }
+
+    /**
+     * @brief decodeText
+     * Parses text datagram, starting after the last '>' of the line.
+     * Checksum is not verified here, see VisuDatagram::checksumOk.
+     * @return false if line does not hold five numbers
+     */
+    bool decodeText(const char* begin, const char* end, VisuDatagram& datagram)
+    {
+        const char* ptr = end;
+        while (ptr != begin && *(ptr - 1) != '>')
+        {
+            --ptr;
+        }
+
+        quint64 values[TEXT_FIELD_COUNT];
+        for (int field = 0; field < TEXT_FIELD_COUNT; ++field)
+        {
+            while (ptr != end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r'))
+            {
+                ++ptr;
+            }
+            if (ptr == end || *ptr < '0' || *ptr > '9')
+            {
+                return false;
+            }
+
+            quint64 value = 0;
+            while (ptr != end && *ptr >= '0' && *ptr <= '9')
+            {
+                value = value * 10 + (*ptr - '0');
+                ++ptr;
+            }
+            values[field] = value;
+        }
+
+        datagram.signalId = (quint16)values[0];
+        datagram.packetNumber = (quint16)values[1];
+        datagram.rawValue = values[2];
+        datagram.timestamp = values[3];
+        datagram.checksum = (quint8)values[4];
+        return true;
+    }
+
+    /**
+     * @brief encodeDatagram
+     * Writes datagram as DATAGRAM_SIZE wire bytes. Checksum is computed
+     * over wire bytes, checksum field of datagram is ignored.
+     */
+    void encodeDatagram(const VisuDatagram& datagram, quint8* wire)
+    {
+        qToBigEndian<quint16>(datagram.signalId, wire);
+        qToBigEndian<quint16>(datagram.packetNumber, wire + 2);
+        qToBigEndian<quint64>(datagram.timestamp, wire + DATAGRAM_VALUES_OFFSET);
+        qToBigEndian<quint64>(datagram.rawValue, wire + DATAGRAM_VALUES_OFFSET + 8);
+        wire[DATAGRAM_CHECKSUM_OFFSET] = xorChecksum(wire, DATAGRAM_CHECKSUM_OFFSET);
+    }
+
+    /**
+     * @brief encodeBatch
+     * Writes datagrams as one batched frame. Packet numbers of datagrams
+     * are replaced by the one of the frame.
+     * @param frame has to hold getBatchSize(count) bytes
+     * @return size of frame
+     */
+    int encodeBatch(const VisuDatagram* datagrams, int count, quint16 packetNumber, quint8* frame)
+    {
+        frame[0] = BATCH_MAGIC_FIRST;
+        frame[1] = BATCH_MAGIC_SECOND;
+        frame[2] = BATCH_VERSION;
+        qToBigEndian<quint16>(packetNumber, frame + 3);
+        qToBigEndian<quint16>(count, frame + 5);
+
+        quint8* record = frame + BATCH_HEADER_SIZE;
+        for (int i = 0; i < count; ++i, record += RECORD_SIZE)
+        {
+            qToBigEndian<quint16>(datagrams[i].signalId, record);
+            qToBigEndian<quint64>(datagrams[i].timestamp, record + RECORD_VALUES_OFFSET);
+            qToBigEndian<quint64>(datagrams[i].rawValue, record + RECORD_VALUES_OFFSET + 8);
+        }
+
+        int size = getBatchSize(count);
+        frame[size - 1] = xorChecksum(frame, size - 1);
+        return size;
+    }
+
+    /**
+     * @brief isBatchFrame
+     * Checks if buffer holds batched frame header and that its size matches
+     * the record count announced in the header.
+     */
+    bool isBatchFrame(const quint8* frame, qint64 size)
+    {
+        if (size < BATCH_HEADER_SIZE + 1
+            || frame[0] != BATCH_MAGIC_FIRST
+            || frame[1] != BATCH_MAGIC_SECOND)
+        {
+            return false;
+        }
+
+        quint16 count = qFromBigEndian<quint16>(frame + 5);
+        return size == getBatchSize(count);
+    }
+
+    /**
+     * @brief decodeBatchHeader
+     * Verifies version and checksum of batched frame, see isBatchFrame.
+     * @param packetNumber set to packet number of the frame
+     * @return number of records, -1 if frame is not valid
+     */
+    int decodeBatchHeader(const quint8* frame, qint64 size, quint16& packetNumber)
+    {
+        if (frame[2] != BATCH_VERSION || xorChecksum(frame, size - 1) != frame[size - 1])
+        {
+            return -1;
+        }
+
+        packetNumber = qFromBigEndian<quint16>(frame + 3);
+        return qFromBigEndian<quint16>(frame + 5);
+    }
+
+    int getBatchSize(int count)
+    {
+        return BATCH_HEADER_SIZE + count * RECORD_SIZE + 1;
+    }
+
+    /**
+     * @brief encodeCobs
+     * Encodes data with consistent overhead byte stuffing, so that it
+     * holds no zero bytes. Terminating zero is not added.
+     * @param encoded has to hold getCobsMaxSize(size) bytes
+     * @return size of encoded data
+     */
+    int encodeCobs(const quint8* data, int size, quint8* encoded)
+    {
+        int codeIndex = 0;
+        int position = 1;
+        quint8 code = 1;
+
+        for (int i = 0; i < size; ++i)
+        {
+            if (data[i] == 0x0)
+            {
+                encoded[codeIndex] = code;
+                codeIndex = position++;
+                code = 1;
+            }
+            else
+            {
+                encoded[position++] = data[i];
+                if (++code == COBS_MAX_CODE)
+                {
+                    encoded[codeIndex] = code;
+                    codeIndex = position++;
+                    code = 1;
+                }
+            }
+        }
+        encoded[codeIndex] = code;
+
+        return position;
+    }
+
+    /**
+     * @brief decodeCobs
+     * Decodes COBS frame, without terminating zero.
+     * @param data has to hold size bytes
+     * @return size of decoded data, -1 if frame is malformed
+     */
+    int decodeCobs(const quint8* encoded, int size, quint8* data)
+    {
+        int position = 0;
+        int i = 0;
+        while (i < size)
+        {
+            quint8 code = encoded[i++];
+            if (code == 0x0 || i + code - 1 > size)
+            {
+                return -1;
+            }
+
+            for (int j = 1; j < code; ++j)
+            {
+                // zero never appears in encoded frame
+                if (encoded[i] == 0x0)
+                {
+                    return -1;
+                }
+                data[position++] = encoded[i++];
+            }
+
+            if (code != COBS_MAX_CODE && i < size)
+            {
+                data[position++] = 0x0;
+            }
+        }
+
+        return position;
+    }
+
+    int getCobsMaxSize(int size)
+    {
+        return size + size / (COBS_MAX_CODE - 1) + 1;
+    }
+
+    const char* getImplementation()
+    {
+        return implementation().name;
+    }
+
+    /**
+     * @brief useImplementation
+     * Switches to implementation of given name, "scalar", "SSE2" or
+     * "AVX2". Meant for tests comparing implementations, not thread safe.
+     * @return false if implementation is not supported by this CPU
+     */
+    bool useImplementation(const char* name)
+    {
+        QByteArray requested(name);
+        if (requested == SCALAR.name)
+        {
+            implementation() = SCALAR;
+            return true;
+        }
+#ifdef VISU_WIRE_X86
+        if (requested == SSE2.name)
+        {
+            implementation() = SSE2;
+            return true;
+        }
+        if (requested == AVX2.name && __builtin_cpu_supports("avx2"))
+        {
+            implementation() = AVX2;
+            return true;
+        }
+#endif
+        return false;
+    }
+}
@@ -22,8 +22,29 @@ VisuWidget* VisuWidgetFactory::createWidget(QWidget* parent,
 VisuWidget* VisuWidgetFactory::createWidget(QWidget* parent,
                                             QMap<QString, QString> properties)
 {
-    QString type = properties[VisuWidget::KEY_TYPE];
-    QMap<QString, VisuPropertyMeta> metaProperties = VisuConfigLoader::getMetaMapFromFile(type, VisuWidget::TAG_NAME);
+    VisuWidget* widget = VisuWidgetFactory::constructWidget(parent, properties);
+
+    VisuInstrument* visuWidget = qobject_cast<VisuInstrument*>(widget);
+    if (visuWidget != nullptr)
+    {
+        visuWidget->connectSignals();
+    }
+
+    return widget;
+}
+
+/**
+ * @brief VisuWidgetFactory::constructWidget
+ * Creates widget without connecting it to signals.
+ * @param parent
+ * @param properties
+ * @return
+ */
+VisuWidget* VisuWidgetFactory::constructWidget(QWidget* parent,
+                                               const QMap<QString, QString>& properties)
+{
+    QString type = properties.value(VisuWidget::KEY_TYPE);
+    const QMap<QString, VisuPropertyMeta>& metaProperties = VisuConfigLoader::getMetaMap(type, VisuWidget::TAG_NAME);
 
     VisuWidget* widget = nullptr;
 
@@ -71,11 +92,6 @@ VisuWidget* VisuWidgetFactory::createWidget(QWidget* parent,
     if (widget != nullptr)
     {
         widget->setPropertiesMeta(metaProperties);
-        VisuInstrument* visuWidget = qobject_cast<VisuInstrument*>(widget);
-        if (visuWidget != nullptr)
-        {
-            visuWidget->connectSignals();
-        }
     }
 
     return widget;
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Datagram decoding benchmark
+#
+#-------------------------------------------------
+
+QT       += testlib
+QT       -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+TARGET = tst_codecbenchmark
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../includes
+
+SOURCES += tst_codecbenchmark.cpp \
+    ../../src/visuwirecodec.cpp \
+    ../../src/visudatagram.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,217 @@
+#include <QString>
+#include <QtTest>
+#include <QVector>
+#include <qendian.h>
+
+#include "visudatagram.h"
+#include "visuwirecodec.h"
+
+/**
+ * Compares VisuWireCodec with decoding as it was done before: field by
+ * field conversion in createDatagramFromBuffer, followed by checksum over
+ * bytes of the in-memory struct.
+ *
+ * Codec implementation is picked by CPU, run with VISU_WIRE_CODEC=scalar
+ * to measure the scalar fallback.
+ */
+class TestCodecBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestCodecBenchmark();
+
+private Q_SLOTS:
+    void initTestCase();
+    void testDatagrams_data();
+    void testDatagrams();
+    void testBatch_data();
+    void testBatch();
+
+private:
+    static VisuDatagram legacyCreateDatagram(const quint8* buffer);
+    static bool legacyChecksumOk(VisuDatagram& datagram);
+
+    QByteArray mDatagrams;
+    QByteArray mBatch;
+
+    static const int DATAGRAM_COUNT = 4096;
+    static const int RECORD_COUNT = 3000;
+    static const int BATCH_HEADER_SIZE = 7;
+};
+
+TestCodecBenchmark::TestCodecBenchmark()
+{
+}
+
+void TestCodecBenchmark::initTestCase()
+{
+    qDebug("Codec implementation: %s", VisuWireCodec::getImplementation());
+
+    qsrand(1);
+    mDatagrams.resize(DATAGRAM_COUNT * VisuWireCodec::DATAGRAM_SIZE);
+    quint8* datagram = (quint8*)mDatagrams.data();
+    for (int i = 0; i < DATAGRAM_COUNT; ++i, datagram += VisuWireCodec::DATAGRAM_SIZE)
+    {
+        quint8 sum = 0x0;
+        for (int j = 0; j < VisuWireCodec::DATAGRAM_SIZE - 1; ++j)
+        {
+            datagram[j] = qrand();
+            sum ^= datagram[j];
+        }
+        datagram[VisuWireCodec::DATAGRAM_SIZE - 1] = sum;
+    }
+
+    mBatch.resize(BATCH_HEADER_SIZE + RECORD_COUNT * VisuWireCodec::RECORD_SIZE + 1);
+    quint8* frame = (quint8*)mBatch.data();
+    quint8 sum = 0x0;
+    for (int i = 0; i < mBatch.size() - 1; ++i)
+    {
+        frame[i] = qrand();
+        sum ^= frame[i];
+    }
+    frame[mBatch.size() - 1] = sum;
+}
+
+VisuDatagram TestCodecBenchmark::legacyCreateDatagram(const quint8* buffer)
+{
+    VisuDatagram datagram;
+
+    datagram.signalId = qFromBigEndian<quint16>((uchar*)buffer);
+    buffer += 2;
+
+    datagram.packetNumber = qFromBigEndian<quint16>((uchar*)buffer);
+    buffer += 2;
+
+    datagram.timestamp = qFromBigEndian<quint64>((uchar*)buffer);
+    buffer += 8;
+
+    datagram.rawValue = qFromBigEndian<quint64>((uchar*)buffer);
+    buffer += 8;
+
+    datagram.checksum = *buffer;
+
+    return datagram;
+}
+
+bool TestCodecBenchmark::legacyChecksumOk(VisuDatagram& datagram)
+{
+    quint8* ptr = (quint8*)&datagram;
+    quint8* end = &(datagram.checksum);
+    quint8 sum = 0x0;
+
+    while (ptr != end)
+    {
+        sum ^= *ptr;
+        ++ptr;
+    }
+    return sum == datagram.checksum;
+}
+
+void TestCodecBenchmark::testDatagrams_data()
+{
+    QTest::addColumn<bool>("legacy");
+
+    QTest::newRow("legacy") << true;
+    QTest::newRow("codec") << false;
+}
+
+void TestCodecBenchmark::testDatagrams()
+{
+    QFETCH(bool, legacy);
+
+    const quint8* datagrams = (const quint8*)mDatagrams.constData();
+    int valid = 0;
+    quint64 total = 0;
+
+    QBENCHMARK
+    {
+        valid = 0;
+        total = 0;
+        for (int i = 0; i < DATAGRAM_COUNT; ++i)
+        {
+            const quint8* wire = datagrams + i * VisuWireCodec::DATAGRAM_SIZE;
+            VisuDatagram datagram;
+            bool ok;
+            if (legacy)
+            {
+                datagram = legacyCreateDatagram(wire);
+                ok = legacyChecksumOk(datagram);
+            }
+            else
+            {
+                ok = VisuWireCodec::decodeDatagram(wire, datagram);
+            }
+            valid += ok;
+            total += datagram.rawValue;
+        }
+    }
+
+    QCOMPARE(valid, (int)DATAGRAM_COUNT);
+    QVERIFY(total != 0);
+}
+
+void TestCodecBenchmark::testBatch_data()
+{
+    QTest::addColumn<bool>("legacy");
+
+    QTest::newRow("legacy") << true;
+    QTest::newRow("codec") << false;
+}
+
+void TestCodecBenchmark::testBatch()
+{
+    QFETCH(bool, legacy);
+
+    const quint8* buffer = (const quint8*)mBatch.constData();
+    const qint64 size = mBatch.size();
+    QVector<VisuDatagram> batch;
+    bool valid = false;
+
+    QBENCHMARK
+    {
+        quint16 packetNumber = qFromBigEndian<quint16>((uchar*)buffer + 3);
+        if (legacy)
+        {
+            const quint8* end = buffer + size - 1;
+            quint8 sum = 0x0;
+            for (const quint8* ptr = buffer; ptr != buffer + BATCH_HEADER_SIZE; ++ptr)
+            {
+                sum ^= *ptr;
+            }
+
+            batch.resize(0);
+            for (const quint8* record = buffer + BATCH_HEADER_SIZE; record != end; record += VisuWireCodec::RECORD_SIZE)
+            {
+                VisuDatagram datagram;
+                datagram.signalId = qFromBigEndian<quint16>((uchar*)record);
+                datagram.packetNumber = packetNumber;
+                datagram.timestamp = qFromBigEndian<quint64>((uchar*)record + 2);
+                datagram.rawValue = qFromBigEndian<quint64>((uchar*)record + 10);
+                datagram.checksum = 0x0;
+                batch.append(datagram);
+
+                for (int i = 0; i < VisuWireCodec::RECORD_SIZE; ++i)
+                {
+                    sum ^= record[i];
+                }
+            }
+            valid = (sum == *end);
+        }
+        else
+        {
+            valid = (VisuWireCodec::xorChecksum(buffer, size - 1) == buffer[size - 1]);
+            batch.resize(RECORD_COUNT);
+            VisuWireCodec::decodeRecords(buffer + BATCH_HEADER_SIZE, RECORD_COUNT, packetNumber, batch.data());
+        }
+    }
+
+    QVERIFY(valid);
+    QCOMPARE(batch.size(), (int)RECORD_COUNT);
+    QCOMPARE(batch.last().rawValue,
+             qFromBigEndian<quint64>((uchar*)buffer + size - 1 - VisuWireCodec::RECORD_SIZE + 10));
+}
+
+QTEST_MAIN(TestCodecBenchmark)
+
+#include "tst_codecbenchmark.moc"
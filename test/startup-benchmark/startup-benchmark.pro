@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# Configuration loading benchmark
+#
+#-------------------------------------------------
+
+QT       += testlib
+
+TARGET = tst_startupbenchmark
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+include(../../project/visualization.pri)
+
+SOURCES += tst_startupbenchmark.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,155 @@
+#include <QString>
+#include <QtTest>
+#include <QWidget>
+
+#include "visuconfiguration.h"
+#include "visuconfigloader.h"
+#include "visumisc.h"
+#include "instruments/instanalog.h"
+#include "instruments/instdigital.h"
+#include "instruments/instlinear.h"
+#include "instruments/insttimeplot.h"
+#include "instruments/instled.h"
+#include "instruments/instxyplot.h"
+
+/**
+ * Measures VisuConfiguration::fromXML on synthetic configurations and
+ * reports duration and peak memory of every load phase.
+ *
+ * Peak memory is the high-water mark of the whole process, so sizes run
+ * later inherit peaks of the earlier ones. For isolated numbers run one
+ * size at a time, e.g. "tst_startupbenchmark testStartup:1000". Meta
+ * registry is process-wide as well, so only the first run parses meta
+ * files.
+ */
+class TestStartupBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestStartupBenchmark();
+
+private Q_SLOTS:
+    void initTestCase();
+    void testStartup_data();
+    void testStartup();
+
+private:
+    QString generateConfiguration(int count);
+    void reportProfile(int count, const VisuConfiguration::LoadProfile& profile);
+
+    static const int GRID_STEP = 20;
+    static const int GRID_COLUMNS = 100;
+};
+
+TestStartupBenchmark::TestStartupBenchmark()
+{
+}
+
+void TestStartupBenchmark::initTestCase()
+{
+    // meta files are loaded from path relative to repository root
+    QDir::setCurrent(QString(SRCDIR) + "../..");
+}
+
+QString TestStartupBenchmark::generateConfiguration(int count)
+{
+    const QStringList types = { InstAnalog::TAG_NAME,
+                                InstDigital::TAG_NAME,
+                                InstLinear::TAG_NAME,
+                                InstTimePlot::TAG_NAME,
+                                InstLED::TAG_NAME,
+                                InstXYPlot::TAG_NAME };
+
+    QMap<QString, QString> configuration;
+    const QMap<QString, VisuPropertyMeta>& meta = VisuConfigLoader::getMetaMap(VisuConfiguration::TAG_NAME,
+                                                                               VisuConfiguration::TAG_NAME);
+    for (auto itr = meta.constBegin(); itr != meta.constEnd(); ++itr)
+    {
+        configuration[itr.key()] = itr.value().defaultVal;
+    }
+
+    QString xml = VisuMisc::getXMLDeclaration();
+    xml += VisuMisc::openTag(VisuConfiguration::TAG_VISU_CONFIG);
+    xml += VisuMisc::addElement(VisuConfiguration::TAG_NAME, configuration, 1);
+
+    xml += VisuMisc::openTag(VisuConfiguration::TAG_SIGNALS_PLACEHOLDER, 1);
+    QMap<QString, QString> signalProperties = VisuConfigLoader::getMapFromFile(VisuSignal::TAG_NAME, VisuSignal::TAG_NAME);
+    for (int i = 0; i < count; ++i)
+    {
+        signalProperties["id"] = QString::number(i);
+        signalProperties["name"] = QString("Signal %1").arg(i);
+        xml += VisuMisc::addElement(VisuSignal::TAG_NAME, signalProperties, 2);
+    }
+    xml += VisuMisc::closeTag(VisuConfiguration::TAG_SIGNALS_PLACEHOLDER, 1);
+
+    xml += VisuMisc::openTag(VisuConfiguration::TAG_WIDGETS_PLACEHOLDER, 1);
+    QVector<QMap<QString, QString>> defaults;
+    for (const QString& type : types)
+    {
+        defaults.append(VisuConfigLoader::getMapFromFile(type, VisuWidget::TAG_NAME));
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        QMap<QString, QString> widget = defaults[i % defaults.size()];
+        widget[VisuWidget::KEY_ID] = QString::number(i);
+        widget[VisuWidget::KEY_X] = QString::number((i % GRID_COLUMNS) * GRID_STEP);
+        widget[VisuWidget::KEY_Y] = QString::number((i / GRID_COLUMNS) * GRID_STEP);
+        widget["signalId"] = QString::number(i);
+        xml += VisuMisc::addElement(VisuWidget::TAG_NAME, widget, 2);
+    }
+    xml += VisuMisc::closeTag(VisuConfiguration::TAG_WIDGETS_PLACEHOLDER, 1);
+
+    xml += VisuMisc::closeTag(VisuConfiguration::TAG_VISU_CONFIG);
+    return xml;
+}
+
+void TestStartupBenchmark::reportProfile(int count, const VisuConfiguration::LoadProfile& profile)
+{
+    const char* names[VisuConfiguration::PHASE_COUNT] = { "XML tokenize",
+                                                          "meta load",
+                                                          "widget construction",
+                                                          "signal wiring",
+                                                          "initial render" };
+
+    qDebug("%d widgets and signals:", count);
+    for (int phase = 0; phase < VisuConfiguration::PHASE_COUNT; ++phase)
+    {
+        qDebug("  %-20s %10.3f ms %10lld kB peak",
+               names[phase],
+               profile.elapsedNs[phase] / 1e6,
+               profile.peakMemoryKb[phase]);
+    }
+}
+
+void TestStartupBenchmark::testStartup_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void TestStartupBenchmark::testStartup()
+{
+    QFETCH(int, count);
+
+    QString xml = generateConfiguration(count);
+    QWidget stage;
+    VisuConfiguration* configuration = VisuConfiguration::getClean();
+
+    QBENCHMARK_ONCE
+    {
+        configuration->fromXML(&stage, xml);
+    }
+
+    QCOMPARE(configuration->getWidgets().size(), count);
+    QCOMPARE(configuration->getSignals().size(), count);
+    reportProfile(count, configuration->getLoadProfile());
+}
+
+QTEST_MAIN(TestStartupBenchmark)
+
+#include "tst_startupbenchmark.moc"
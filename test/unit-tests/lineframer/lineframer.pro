@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# Serial line framer unit tests
+#
+#-------------------------------------------------
+
+QT       += testlib
+QT       -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+TARGET = tst_lineframer
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../../includes
+
+SOURCES += tst_lineframer.cpp \
+    ../../../src/visulineframer.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,177 @@
+#include <QString>
+#include <QtTest>
+#include <QList>
+
+#include "visulineframer.h"
+
+/**
+ * Feeds VisuLineFramer the way serial port reads do, in pieces of any
+ * size, and checks lines that come out.
+ */
+class TestLineFramer : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestLineFramer();
+
+private Q_SLOTS:
+    void testEmptyLines();
+    void testDelimiterInLaterRead();
+    void testByteByByte();
+    void testWrapAround();
+    void testOverflow();
+    void testOverflowAcrossReads();
+
+private:
+    static bool write(VisuLineFramer& framer, const QByteArray& data);
+    static QList<QByteArray> readLines(VisuLineFramer& framer);
+
+    static const int CAPACITY = 16;
+};
+
+TestLineFramer::TestLineFramer()
+{
+}
+
+/**
+ * @brief TestLineFramer::write
+ * Copies data into framer, in as many pieces as the ring needs.
+ * @return false if ring got full before all data was written
+ */
+bool TestLineFramer::write(VisuLineFramer& framer, const QByteArray& data)
+{
+    int written = 0;
+    while (written < data.size())
+    {
+        int size;
+        char* buffer = framer.getWriteBuffer(size);
+        if (size == 0)
+        {
+            return false;
+        }
+        size = qMin(size, data.size() - written);
+        memcpy(buffer, data.constData() + written, size);
+        framer.commit(size);
+        written += size;
+    }
+    return true;
+}
+
+QList<QByteArray> TestLineFramer::readLines(VisuLineFramer& framer)
+{
+    QList<QByteArray> lines;
+    const char* line;
+    int length;
+    while (framer.nextLine(line, length))
+    {
+        lines.append(QByteArray(line, length));
+    }
+    return lines;
+}
+
+void TestLineFramer::testEmptyLines()
+{
+    VisuLineFramer framer(CAPACITY);
+    QVERIFY(write(framer, "\n\nab\n\n"));
+
+    QList<QByteArray> lines = readLines(framer);
+    QCOMPARE(lines.size(), 4);
+    QCOMPARE(lines[0], QByteArray());
+    QCOMPARE(lines[1], QByteArray());
+    QCOMPARE(lines[2], QByteArray("ab"));
+    QCOMPARE(lines[3], QByteArray());
+}
+
+void TestLineFramer::testDelimiterInLaterRead()
+{
+    VisuLineFramer framer(CAPACITY, '\r');
+    QVERIFY(write(framer, "abc"));
+    QCOMPARE(readLines(framer).size(), 0);
+
+    QVERIFY(write(framer, "\rde"));
+    QList<QByteArray> lines = readLines(framer);
+    QCOMPARE(lines.size(), 1);
+    QCOMPARE(lines[0], QByteArray("abc"));
+
+    QVERIFY(write(framer, "f\r"));
+    lines = readLines(framer);
+    QCOMPARE(lines.size(), 1);
+    QCOMPARE(lines[0], QByteArray("def"));
+}
+
+void TestLineFramer::testByteByByte()
+{
+    VisuLineFramer framer(CAPACITY);
+    QByteArray stream(">1 2 3 4 5\n>6 7 8 9 10\n");
+
+    QList<QByteArray> lines;
+    for (char byte : stream)
+    {
+        QVERIFY(write(framer, QByteArray(1, byte)));
+        lines.append(readLines(framer));
+    }
+    QCOMPARE(lines.size(), 2);
+    QCOMPARE(lines[0], QByteArray(">1 2 3 4 5"));
+    QCOMPARE(lines[1], QByteArray(">6 7 8 9 10"));
+}
+
+void TestLineFramer::testWrapAround()
+{
+    VisuLineFramer framer(CAPACITY);
+
+    // every start offset, so lines wrap at each position of the ring
+    for (int i = 0; i < 3 * CAPACITY; ++i)
+    {
+        QByteArray line = QByteArray::number(i).rightJustified(CAPACITY - 1, 'x');
+        QVERIFY(write(framer, line.left(i % CAPACITY)));
+        QVERIFY(write(framer, line.mid(i % CAPACITY) + '\n'));
+
+        QList<QByteArray> lines = readLines(framer);
+        QCOMPARE(lines.size(), 1);
+        QCOMPARE(lines[0], line);
+    }
+    QCOMPARE(framer.getOverflows(), (quint64)0);
+}
+
+void TestLineFramer::testOverflow()
+{
+    VisuLineFramer framer(CAPACITY);
+    QVERIFY(write(framer, "ok\n"));
+    QCOMPARE(readLines(framer).size(), 1);
+
+    // line without delimiter fills the ring
+    QVERIFY(write(framer, QByteArray(CAPACITY, 'x')));
+    QCOMPARE(readLines(framer).size(), 0);
+    QCOMPARE(framer.getOverflows(), (quint64)1);
+
+    // rest of it is skipped up to the next delimiter
+    QVERIFY(write(framer, "xxx\nnext\n"));
+    QList<QByteArray> lines = readLines(framer);
+    QCOMPARE(lines.size(), 1);
+    QCOMPARE(lines[0], QByteArray("next"));
+    QCOMPARE(framer.getOverflows(), (quint64)1);
+}
+
+void TestLineFramer::testOverflowAcrossReads()
+{
+    VisuLineFramer framer(CAPACITY);
+
+    // line several times the ring, delimiter only in the last piece
+    for (int i = 0; i < 4; ++i)
+    {
+        QVERIFY(write(framer, QByteArray(CAPACITY, 'x')));
+        QCOMPARE(readLines(framer).size(), 0);
+    }
+    QCOMPARE(framer.getOverflows(), (quint64)1);
+
+    QVERIFY(write(framer, "x\n\nlast\n"));
+    QList<QByteArray> lines = readLines(framer);
+    QCOMPARE(lines.size(), 2);
+    QCOMPARE(lines[0], QByteArray());
+    QCOMPARE(lines[1], QByteArray("last"));
+}
+
+QTEST_APPLESS_MAIN(TestLineFramer)
+
+#include "tst_lineframer.moc"
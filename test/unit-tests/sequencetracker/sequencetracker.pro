@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# Packet sequence tracker unit tests
+#
+#-------------------------------------------------
+
+QT       += testlib
+QT       -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+TARGET = tst_sequencetracker
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../../includes
+
+SOURCES += tst_sequencetracker.cpp \
+    ../../../src/visusequencetracker.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,211 @@
+#include <QString>
+#include <QtTest>
+#include <QVector>
+
+#include "visusequencetracker.h"
+
+/**
+ * Feeds VisuSequenceTracker packet numbers of one signal or source and
+ * checks how they are judged.
+ */
+class TestSequenceTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSequenceTracker();
+
+private Q_SLOTS:
+    void testInOrder();
+    void testGap();
+    void testWrapAround();
+    void testGapAcrossWrap();
+    void testDuplicate();
+    void testReordered();
+    void testReorderedAcrossWrap();
+    void testReset();
+    void testDropStale();
+    void testFrames();
+    void testPublish();
+
+private:
+    static VisuSequenceStats feed(VisuSequenceTracker& tracker, const QVector<int>& packetNumbers);
+};
+
+namespace
+{
+    const quint16 SIGNAL_ID = 7;
+}
+
+TestSequenceTracker::TestSequenceTracker()
+{
+}
+
+VisuSequenceStats TestSequenceTracker::feed(VisuSequenceTracker& tracker, const QVector<int>& packetNumbers)
+{
+    for (int packetNumber : packetNumbers)
+    {
+        tracker.accept(SIGNAL_ID, packetNumber);
+    }
+    tracker.publish();
+    return tracker.getStats().value(SIGNAL_ID);
+}
+
+void TestSequenceTracker::testInOrder()
+{
+    VisuSequenceTracker tracker;
+    VisuSequenceStats stats = feed(tracker, { 10, 11, 12, 13 });
+    QCOMPARE(stats.received, (quint64)4);
+    QCOMPARE(stats.gaps, (quint64)0);
+    QCOMPARE(stats.duplicates, (quint64)0);
+    QCOMPARE(stats.reordered, (quint64)0);
+    QCOMPARE(stats.resets, (quint64)0);
+    QCOMPARE(stats.lastPacketNumber, (quint16)13);
+}
+
+void TestSequenceTracker::testGap()
+{
+    VisuSequenceTracker tracker;
+    VisuSequenceStats stats = feed(tracker, { 10, 11, 15, 16 });
+    QCOMPARE(stats.gaps, (quint64)3);
+    QCOMPARE(stats.getLost(), (quint64)3);
+}
+
+void TestSequenceTracker::testWrapAround()
+{
+    VisuSequenceTracker tracker;
+    VisuSequenceStats stats = feed(tracker, { 65534, 65535, 0, 1 });
+    QCOMPARE(stats.gaps, (quint64)0);
+    QCOMPARE(stats.reordered, (quint64)0);
+    QCOMPARE(stats.resets, (quint64)0);
+    QCOMPARE(stats.lastPacketNumber, (quint16)1);
+}
+
+void TestSequenceTracker::testGapAcrossWrap()
+{
+    VisuSequenceTracker tracker;
+    VisuSequenceStats stats = feed(tracker, { 65534, 2 });
+    QCOMPARE(stats.gaps, (quint64)3);
+    QCOMPARE(stats.resets, (quint64)0);
+}
+
+void TestSequenceTracker::testDuplicate()
+{
+    VisuSequenceTracker tracker;
+    QVERIFY(tracker.accept(SIGNAL_ID, 5));
+    QVERIFY(tracker.accept(SIGNAL_ID, 5));
+    VisuSequenceStats stats = feed(tracker, { 6, 6 });
+    QCOMPARE(stats.received, (quint64)4);
+    QCOMPARE(stats.duplicates, (quint64)2);
+    QCOMPARE(stats.reordered, (quint64)0);
+    QCOMPARE(stats.staleDropped, (quint64)0);
+    QCOMPARE(stats.lastPacketNumber, (quint16)6);
+}
+
+void TestSequenceTracker::testReordered()
+{
+    VisuSequenceTracker tracker;
+    VisuSequenceStats stats = feed(tracker, { 10, 12, 11, 13 });
+    QCOMPARE(stats.gaps, (quint64)1);
+    QCOMPARE(stats.reordered, (quint64)1);
+    QCOMPARE(stats.getLost(), (quint64)0);
+    QCOMPARE(stats.lastPacketNumber, (quint16)13);
+
+    // oldest number still taken as reordered
+    stats = feed(tracker, { 13 - VisuSequenceTracker::MAX_REORDER });
+    QCOMPARE(stats.reordered, (quint64)2);
+    QCOMPARE(stats.resets, (quint64)0);
+    QCOMPARE(stats.lastPacketNumber, (quint16)13);
+}
+
+void TestSequenceTracker::testReorderedAcrossWrap()
+{
+    VisuSequenceTracker tracker;
+    VisuSequenceStats stats = feed(tracker, { 65535, 1, 0 });
+    QCOMPARE(stats.gaps, (quint64)1);
+    QCOMPARE(stats.reordered, (quint64)1);
+    QCOMPARE(stats.resets, (quint64)0);
+    QCOMPARE(stats.lastPacketNumber, (quint16)1);
+}
+
+void TestSequenceTracker::testReset()
+{
+    VisuSequenceTracker tracker;
+    VisuSequenceStats stats = feed(tracker, { 1000, 1001 });
+
+    // further back than MAX_REORDER, sender restarted numbering
+    stats = feed(tracker, { 1001 - VisuSequenceTracker::MAX_REORDER - 1 });
+    QCOMPARE(stats.resets, (quint64)1);
+    QCOMPARE(stats.reordered, (quint64)0);
+    QCOMPARE(stats.lastPacketNumber, (quint16)(1001 - VisuSequenceTracker::MAX_REORDER - 1));
+
+    // numbering continues from restart point
+    stats = feed(tracker, { 0, 1, 2 });
+    QCOMPARE(stats.resets, (quint64)2);
+    QCOMPARE(stats.gaps, (quint64)0);
+    QCOMPARE(stats.lastPacketNumber, (quint16)2);
+}
+
+void TestSequenceTracker::testDropStale()
+{
+    VisuSequenceTracker tracker;
+    tracker.setDropStale(true);
+    QVERIFY(tracker.accept(SIGNAL_ID, 10));
+    QVERIFY(tracker.accept(SIGNAL_ID, 12));
+    QVERIFY(!tracker.accept(SIGNAL_ID, 12));
+    QVERIFY(!tracker.accept(SIGNAL_ID, 11));
+    QVERIFY(tracker.accept(SIGNAL_ID, 13));
+
+    VisuSequenceStats stats = feed(tracker, {});
+    QCOMPARE(stats.duplicates, (quint64)1);
+    QCOMPARE(stats.reordered, (quint64)1);
+    QCOMPARE(stats.staleDropped, (quint64)2);
+}
+
+void TestSequenceTracker::testFrames()
+{
+    VisuSequenceTracker tracker;
+    tracker.setDropStale(true);
+    const quint64 first = 1;
+    const quint64 second = 2;
+
+    // sources are numbered independently
+    QVERIFY(tracker.acceptFrame(first, 100, 32));
+    QVERIFY(tracker.acceptFrame(second, 5, 32));
+    QVERIFY(tracker.acceptFrame(first, 101, 32));
+    QVERIFY(tracker.acceptFrame(second, 6, 32));
+    QVERIFY(!tracker.acceptFrame(first, 101, 20));
+    QVERIFY(tracker.acceptFrame(second, 9, 32));
+    tracker.publish();
+
+    QMap<quint64, VisuSequenceStats> stats = tracker.getFrameStats();
+    QCOMPARE(stats.size(), 2);
+    QCOMPARE(stats[first].received, (quint64)3);
+    QCOMPARE(stats[first].duplicates, (quint64)1);
+    QCOMPARE(stats[first].staleDropped, (quint64)20);
+    QCOMPARE(stats[first].gaps, (quint64)0);
+    QCOMPARE(stats[second].received, (quint64)3);
+    QCOMPARE(stats[second].gaps, (quint64)2);
+    QVERIFY(tracker.getStats().isEmpty());
+}
+
+void TestSequenceTracker::testPublish()
+{
+    VisuSequenceTracker tracker;
+    tracker.accept(SIGNAL_ID, 1);
+    QVERIFY(tracker.getStats().isEmpty());
+
+    tracker.publish();
+    QCOMPARE(tracker.getStats().value(SIGNAL_ID).received, (quint64)1);
+
+    // snapshot stays until next publish
+    tracker.accept(SIGNAL_ID, 3);
+    QCOMPARE(tracker.getStats().value(SIGNAL_ID).received, (quint64)1);
+    tracker.publish();
+    QCOMPARE(tracker.getStats().value(SIGNAL_ID).received, (quint64)2);
+    QCOMPARE(tracker.getStats().value(SIGNAL_ID).gaps, (quint64)1);
+}
+
+QTEST_APPLESS_MAIN(TestSequenceTracker)
+
+#include "tst_sequencetracker.moc"
@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# Signal history unit tests
+#
+#-------------------------------------------------
+
+QT       += testlib
+QT       -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+TARGET = tst_signalhistory
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../../includes
+
+SOURCES += tst_signalhistory.cpp \
+    ../../../src/visusignalhistory.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
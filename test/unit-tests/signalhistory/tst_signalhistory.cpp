@@ -0,0 +1,232 @@
+#include <QString>
+#include <QtTest>
+#include <QVector>
+
+#include "visusignalhistory.h"
+
+/**
+ * Checks ranges returned by VisuSignalHistory, mostly once the ring has
+ * wrapped around and ranges consist of two spans.
+ */
+class TestSignalHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSignalHistory();
+
+private Q_SLOTS:
+    void testEmpty();
+    void testWrapAround();
+    void testLast();
+    void testSince();
+    void testWindow();
+    void testWindowAcrossWrap();
+    void testOutOfOrder();
+    void testSetCapacity();
+
+private:
+    static void fill(VisuSignalHistory& history, int first, int count);
+    static QVector<quint64> values(const VisuSignalHistory::Range& range);
+    static QVector<quint64> sequence(int first, int count);
+
+    static const int CAPACITY = 8;
+};
+
+TestSignalHistory::TestSignalHistory()
+{
+}
+
+/**
+ * @brief TestSignalHistory::fill
+ * Appends samples with timestamps first * 10, (first + 1) * 10, ...
+ * and raw values equal to their index.
+ */
+void TestSignalHistory::fill(VisuSignalHistory& history, int first, int count)
+{
+    for (int i = first; i < first + count; ++i)
+    {
+        history.append(i * 10, i);
+    }
+}
+
+QVector<quint64> TestSignalHistory::values(const VisuSignalHistory::Range& range)
+{
+    QVector<quint64> result;
+    for (int i = 0; i < range.size(); ++i)
+    {
+        result.append(range.rawValueAt(i));
+    }
+
+    // spans hold the same samples as indexed access
+    QVector<quint64> spans;
+    for (const VisuSignalHistory::Span& span : { range.first, range.second })
+    {
+        for (int i = 0; i < span.size; ++i)
+        {
+            spans.append(span.rawValues[i]);
+        }
+    }
+    return result == spans ? result : QVector<quint64>();
+}
+
+QVector<quint64> TestSignalHistory::sequence(int first, int count)
+{
+    QVector<quint64> result;
+    for (int i = first; i < first + count; ++i)
+    {
+        result.append(i);
+    }
+    return result;
+}
+
+void TestSignalHistory::testEmpty()
+{
+    VisuSignalHistory history;
+    history.append(10, 1);
+    QVERIFY(history.isEmpty());
+    QCOMPARE(history.appended(), (quint64)0);
+
+    history.setCapacity(CAPACITY);
+    QCOMPARE(history.all().size(), 0);
+    QCOMPARE(history.last(3).size(), 0);
+    QCOMPARE(history.since(0).size(), 0);
+    QCOMPARE(history.window(0, 1000).size(), 0);
+}
+
+void TestSignalHistory::testWrapAround()
+{
+    VisuSignalHistory history;
+    history.setCapacity(CAPACITY);
+
+    fill(history, 0, CAPACITY);
+    QCOMPARE(history.all().first.size, CAPACITY);
+    QCOMPARE(history.all().second.size, 0);
+
+    // oldest three overwritten, range splits at end of the ring
+    fill(history, CAPACITY, 3);
+    VisuSignalHistory::Range all = history.all();
+    QCOMPARE(history.size(), CAPACITY);
+    QCOMPARE(history.appended(), (quint64)CAPACITY + 3);
+    QCOMPARE(all.first.size, CAPACITY - 3);
+    QCOMPARE(all.second.size, 3);
+    QCOMPARE(values(all), sequence(3, CAPACITY));
+    QCOMPARE(all.timestampAt(0), (quint64)30);
+    QCOMPARE(all.timestampAt(CAPACITY - 1), (quint64)(CAPACITY + 2) * 10);
+
+    // whole ring once more, back to one span
+    fill(history, CAPACITY + 3, CAPACITY - 3);
+    QCOMPARE(history.all().second.size, 0);
+    QCOMPARE(values(history.all()), sequence(CAPACITY, CAPACITY));
+}
+
+void TestSignalHistory::testLast()
+{
+    VisuSignalHistory history;
+    history.setCapacity(CAPACITY);
+    fill(history, 0, CAPACITY + 5);
+
+    QCOMPARE(history.last(0).size(), 0);
+    QCOMPARE(history.last(-1).size(), 0);
+    QCOMPARE(values(history.last(2)), sequence(CAPACITY + 3, 2));
+    QCOMPARE(values(history.last(6)), sequence(CAPACITY - 1, 6));
+    QCOMPARE(values(history.last(CAPACITY + 1)), sequence(5, CAPACITY));
+}
+
+void TestSignalHistory::testSince()
+{
+    VisuSignalHistory history;
+    history.setCapacity(CAPACITY);
+    fill(history, 0, 5);
+    quint64 seen = history.appended();
+    QCOMPARE(history.since(seen).size(), 0);
+
+    // new samples cross end of the ring
+    fill(history, 5, 6);
+    QCOMPARE(values(history.since(seen)), sequence(5, 6));
+    QCOMPARE(history.since(seen).second.size, 3);
+
+    // some of new samples already overwritten, rest is returned
+    seen = history.appended();
+    fill(history, 11, CAPACITY + 2);
+    QCOMPARE(values(history.since(seen)), sequence(13, CAPACITY));
+    QCOMPARE(values(history.since(0)), sequence(13, CAPACITY));
+
+    // sequence from the future
+    QCOMPARE(history.since(history.appended() + 1).size(), 0);
+}
+
+void TestSignalHistory::testWindow()
+{
+    VisuSignalHistory history;
+    history.setCapacity(CAPACITY);
+    fill(history, 1, 5);    // timestamps 10 to 50
+
+    QCOMPARE(values(history.window(20, 40)), sequence(2, 3));
+    QCOMPARE(values(history.window(15, 45)), sequence(2, 3));
+    QCOMPARE(values(history.window(0, 1000)), sequence(1, 5));
+    QCOMPARE(values(history.window(10, 10)), sequence(1, 1));
+    QCOMPARE(values(history.window(50, 50)), sequence(5, 1));
+    QCOMPARE(history.window(0, 9).size(), 0);
+    QCOMPARE(history.window(51, 1000).size(), 0);
+    QCOMPARE(history.window(21, 29).size(), 0);
+    QCOMPARE(history.window(40, 20).size(), 0);
+
+    // equal timestamps are all inside or all outside
+    history.append(50, 6);
+    history.append(50, 7);
+    QCOMPARE(values(history.window(50, 60)), QVector<quint64>({ 5, 6, 7 }));
+    QCOMPARE(values(history.window(0, 49)), sequence(1, 4));
+}
+
+void TestSignalHistory::testWindowAcrossWrap()
+{
+    VisuSignalHistory history;
+    history.setCapacity(CAPACITY);
+    fill(history, 0, CAPACITY + 5);     // timestamps 50 to 120, ring wraps after 70
+
+    QCOMPARE(values(history.window(0, 1000)), sequence(5, CAPACITY));
+    QCOMPARE(values(history.window(60, 90)), sequence(6, 4));
+    QCOMPARE(history.window(60, 90).first.size, 2);
+    QCOMPARE(history.window(60, 90).second.size, 2);
+    // entirely in wrapped part, one span again
+    QCOMPARE(values(history.window(80, 100)), sequence(8, 3));
+    QCOMPARE(history.window(80, 100).first.size, 3);
+    QCOMPARE(history.window(80, 100).second.size, 0);
+    QCOMPARE(history.window(0, 49).size(), 0);
+}
+
+void TestSignalHistory::testOutOfOrder()
+{
+    VisuSignalHistory history;
+    history.setCapacity(CAPACITY);
+    history.append(10, 1);
+    history.append(30, 3);
+    history.append(20, 2);      // reordered, stored with timestamp 30
+    history.append(40, 4);
+
+    VisuSignalHistory::Range all = history.all();
+    QCOMPARE(values(all), QVector<quint64>({ 1, 3, 2, 4 }));
+    QCOMPARE(all.timestampAt(2), (quint64)30);
+    QCOMPARE(history.window(15, 25).size(), 0);
+    QCOMPARE(values(history.window(30, 30)), QVector<quint64>({ 3, 2 }));
+    QCOMPARE(values(history.window(35, 40)), QVector<quint64>({ 4 }));
+}
+
+void TestSignalHistory::testSetCapacity()
+{
+    VisuSignalHistory history;
+    history.setCapacity(CAPACITY);
+    fill(history, 0, CAPACITY + 3);
+
+    history.setCapacity(CAPACITY / 2);
+    QCOMPARE(history.capacity(), CAPACITY / 2);
+    QVERIFY(history.isEmpty());
+
+    fill(history, 0, CAPACITY);
+    QCOMPARE(values(history.all()), sequence(CAPACITY / 2, CAPACITY / 2));
+}
+
+QTEST_APPLESS_MAIN(TestSignalHistory)
+
+#include "tst_signalhistory.moc"
@@ -0,0 +1,384 @@
+#include <QString>
+#include <QtTest>
+#include <QVector>
+
+#include "visudatagram.h"
+#include "visuwirecodec.h"
+
+/**
+ * Checks that every codec implementation supported by the CPU decodes
+ * the same as the scalar one, and that encoded datagrams and batched
+ * frames decode back to what was encoded.
+ */
+class TestWireCodec : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestWireCodec();
+
+private Q_SLOTS:
+    void cleanup();
+    void testXorChecksum();
+    void testDecodeDatagram();
+    void testDecodeRecords();
+    void testDatagramRoundTrip();
+    void testBatchRoundTrip();
+    void testBatchRejected();
+    void testDecodeText_data();
+    void testDecodeText();
+    void testCobsRoundTrip_data();
+    void testCobsRoundTrip();
+    void testCobsRejected_data();
+    void testCobsRejected();
+
+private:
+    static QVector<quint8> randomBytes(int size);
+    static VisuDatagram randomDatagram();
+    static QStringList getImplementations();
+    static bool sameDatagram(const VisuDatagram& first, const VisuDatagram& second);
+
+    static const int MAX_RECORDS = 67;
+};
+
+TestWireCodec::TestWireCodec()
+{
+    qsrand(1);
+}
+
+void TestWireCodec::cleanup()
+{
+    VisuWireCodec::useImplementation("scalar");
+}
+
+QVector<quint8> TestWireCodec::randomBytes(int size)
+{
+    QVector<quint8> bytes(size);
+    for (int i = 0; i < size; ++i)
+    {
+        bytes[i] = qrand();
+    }
+    return bytes;
+}
+
+VisuDatagram TestWireCodec::randomDatagram()
+{
+    VisuDatagram datagram = {};
+    datagram.signalId = qrand();
+    datagram.packetNumber = qrand();
+    datagram.timestamp = ((quint64)qrand() << 40) ^ ((quint64)qrand() << 20) ^ qrand();
+    datagram.rawValue = ((quint64)qrand() << 42) ^ ((quint64)qrand() << 21) ^ qrand();
+    return datagram;
+}
+
+/**
+ * @brief TestWireCodec::getImplementations
+ * Implementations other than scalar, supported by this CPU.
+ */
+QStringList TestWireCodec::getImplementations()
+{
+    QStringList implementations;
+    for (const char* name : { "SSE2", "AVX2" })
+    {
+        if (VisuWireCodec::useImplementation(name))
+        {
+            implementations.append(name);
+        }
+    }
+    VisuWireCodec::useImplementation("scalar");
+    return implementations;
+}
+
+bool TestWireCodec::sameDatagram(const VisuDatagram& first, const VisuDatagram& second)
+{
+    return first.signalId == second.signalId
+        && first.packetNumber == second.packetNumber
+        && first.timestamp == second.timestamp
+        && first.rawValue == second.rawValue
+        && first.checksum == second.checksum;
+}
+
+void TestWireCodec::testXorChecksum()
+{
+    QVector<quint8> bytes = randomBytes(200);
+    QStringList implementations = getImplementations();
+
+    // every tail length after 8, 16 and 32 byte blocks, at odd offsets too
+    for (int offset = 0; offset < 3; ++offset)
+    {
+        for (int size = 0; size <= 100; ++size)
+        {
+            quint8 expected = 0x0;
+            for (int i = 0; i < size; ++i)
+            {
+                expected ^= bytes[offset + i];
+            }
+
+            VisuWireCodec::useImplementation("scalar");
+            QCOMPARE(VisuWireCodec::xorChecksum(bytes.constData() + offset, size), expected);
+            for (const QString& name : implementations)
+            {
+                VisuWireCodec::useImplementation(name.toLatin1().constData());
+                QCOMPARE(VisuWireCodec::xorChecksum(bytes.constData() + offset, size), expected);
+            }
+        }
+    }
+}
+
+void TestWireCodec::testDecodeDatagram()
+{
+    QStringList implementations = getImplementations();
+    for (int i = 0; i < 100; ++i)
+    {
+        // every other datagram has a broken checksum
+        QVector<quint8> wire = randomBytes(VisuWireCodec::DATAGRAM_SIZE);
+        if (i % 2 == 0)
+        {
+            wire[VisuWireCodec::DATAGRAM_SIZE - 1] = VisuWireCodec::xorChecksum(wire.constData(), VisuWireCodec::DATAGRAM_SIZE - 1);
+        }
+
+        VisuWireCodec::useImplementation("scalar");
+        VisuDatagram expected = {};
+        bool expectedOk = VisuWireCodec::decodeDatagram(wire.constData(), expected);
+        QCOMPARE(expectedOk, wire[VisuWireCodec::DATAGRAM_SIZE - 1] == VisuWireCodec::xorChecksum(wire.constData(), VisuWireCodec::DATAGRAM_SIZE - 1));
+
+        for (const QString& name : implementations)
+        {
+            VisuWireCodec::useImplementation(name.toLatin1().constData());
+            VisuDatagram datagram = {};
+            QCOMPARE(VisuWireCodec::decodeDatagram(wire.constData(), datagram), expectedOk);
+            QVERIFY2(sameDatagram(datagram, expected), qPrintable(name));
+        }
+    }
+}
+
+void TestWireCodec::testDecodeRecords()
+{
+    QStringList implementations = getImplementations();
+
+    // odd and even counts, so AVX2 pairs and its SSE2 tail are both covered
+    for (int count = 0; count <= MAX_RECORDS; ++count)
+    {
+        QVector<quint8> records = randomBytes(count * VisuWireCodec::RECORD_SIZE);
+        quint16 packetNumber = qrand();
+
+        VisuWireCodec::useImplementation("scalar");
+        QVector<VisuDatagram> expected(count);
+        VisuWireCodec::decodeRecords(records.constData(), count, packetNumber, expected.data());
+
+        for (const QString& name : implementations)
+        {
+            VisuWireCodec::useImplementation(name.toLatin1().constData());
+            QVector<VisuDatagram> datagrams(count);
+            VisuWireCodec::decodeRecords(records.constData(), count, packetNumber, datagrams.data());
+            for (int i = 0; i < count; ++i)
+            {
+                QVERIFY2(sameDatagram(datagrams[i], expected[i]), qPrintable(name));
+            }
+        }
+    }
+}
+
+void TestWireCodec::testDatagramRoundTrip()
+{
+    QStringList implementations = getImplementations();
+    implementations.prepend("scalar");
+
+    for (const QString& name : implementations)
+    {
+        VisuWireCodec::useImplementation(name.toLatin1().constData());
+        for (int i = 0; i < 100; ++i)
+        {
+            VisuDatagram datagram = randomDatagram();
+            quint8 wire[VisuWireCodec::DATAGRAM_SIZE];
+            VisuWireCodec::encodeDatagram(datagram, wire);
+
+            VisuDatagram decoded = {};
+            QVERIFY(VisuWireCodec::decodeDatagram(wire, decoded));
+            QVERIFY(decoded.checksumOk());
+            QCOMPARE(decoded.signalId, datagram.signalId);
+            QCOMPARE(decoded.packetNumber, datagram.packetNumber);
+            QCOMPARE(decoded.timestamp, datagram.timestamp);
+            QCOMPARE(decoded.rawValue, datagram.rawValue);
+        }
+    }
+}
+
+void TestWireCodec::testBatchRoundTrip()
+{
+    QStringList implementations = getImplementations();
+    implementations.prepend("scalar");
+
+    for (const QString& name : implementations)
+    {
+        VisuWireCodec::useImplementation(name.toLatin1().constData());
+        for (int count = 0; count <= MAX_RECORDS; ++count)
+        {
+            QVector<VisuDatagram> datagrams(count);
+            for (VisuDatagram& datagram : datagrams)
+            {
+                datagram = randomDatagram();
+            }
+            quint16 packetNumber = qrand();
+
+            QVector<quint8> frame(VisuWireCodec::getBatchSize(count));
+            int size = VisuWireCodec::encodeBatch(datagrams.constData(), count, packetNumber, frame.data());
+            QCOMPARE(size, frame.size());
+            QVERIFY(VisuWireCodec::isBatchFrame(frame.constData(), size));
+
+            quint16 decodedPacketNumber = 0;
+            QCOMPARE(VisuWireCodec::decodeBatchHeader(frame.constData(), size, decodedPacketNumber), count);
+            QCOMPARE(decodedPacketNumber, packetNumber);
+
+            QVector<VisuDatagram> decoded(count);
+            VisuWireCodec::decodeRecords(frame.constData() + VisuWireCodec::BATCH_HEADER_SIZE, count, packetNumber, decoded.data());
+            for (int i = 0; i < count; ++i)
+            {
+                QCOMPARE(decoded[i].signalId, datagrams[i].signalId);
+                QCOMPARE(decoded[i].packetNumber, packetNumber);
+                QCOMPARE(decoded[i].timestamp, datagrams[i].timestamp);
+                QCOMPARE(decoded[i].rawValue, datagrams[i].rawValue);
+            }
+        }
+    }
+}
+
+void TestWireCodec::testBatchRejected()
+{
+    QVector<VisuDatagram> datagrams(3);
+    for (VisuDatagram& datagram : datagrams)
+    {
+        datagram = randomDatagram();
+    }
+    QVector<quint8> frame(VisuWireCodec::getBatchSize(datagrams.size()));
+    int size = VisuWireCodec::encodeBatch(datagrams.constData(), datagrams.size(), 7, frame.data());
+    quint16 packetNumber;
+
+    // size not matching record count
+    QVERIFY(!VisuWireCodec::isBatchFrame(frame.constData(), size - 1));
+
+    // any flipped bit breaks checksum
+    for (int i = VisuWireCodec::BATCH_HEADER_SIZE; i < size; ++i)
+    {
+        QVector<quint8> corrupted = frame;
+        corrupted[i] ^= 0x10;
+        QCOMPARE(VisuWireCodec::decodeBatchHeader(corrupted.constData(), size, packetNumber), -1);
+    }
+
+    // unsupported version
+    QVector<quint8> future = frame;
+    future[2] = VisuWireCodec::BATCH_VERSION + 1;
+    future[size - 1] = VisuWireCodec::xorChecksum(future.constData(), size - 1);
+    QCOMPARE(VisuWireCodec::decodeBatchHeader(future.constData(), size, packetNumber), -1);
+
+    // plain datagram is not taken for batched frame
+    quint8 wire[VisuWireCodec::DATAGRAM_SIZE];
+    VisuWireCodec::encodeDatagram(datagrams[0], wire);
+    wire[0] = 0x0;
+    QVERIFY(!VisuWireCodec::isBatchFrame(wire, VisuWireCodec::DATAGRAM_SIZE));
+}
+
+void TestWireCodec::testDecodeText_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<quint16>("signalId");
+    QTest::addColumn<quint16>("packetNumber");
+    QTest::addColumn<quint64>("rawValue");
+    QTest::addColumn<quint64>("timestamp");
+
+    QTest::newRow("valid") << QByteArray(">12 3 456 789 10") << true << (quint16)12 << (quint16)3 << (quint64)456 << (quint64)789;
+    QTest::newRow("tabs and carriage return") << QByteArray(">12\t3  456 789 10\r") << true << (quint16)12 << (quint16)3 << (quint64)456 << (quint64)789;
+    QTest::newRow("noise before marker") << QByteArray("#!>12 3 456 789 10") << true << (quint16)12 << (quint16)3 << (quint64)456 << (quint64)789;
+    QTest::newRow("last marker counts") << QByteArray(">1 1 1>12 3 456 789 10") << true << (quint16)12 << (quint16)3 << (quint64)456 << (quint64)789;
+    // parsed from the beginning, as serial parsing always did
+    QTest::newRow("missing marker") << QByteArray("12 3 456 789 10") << true << (quint16)12 << (quint16)3 << (quint64)456 << (quint64)789;
+    QTest::newRow("missing marker, text") << QByteArray("id 12 3 456 789 10") << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+    QTest::newRow("empty") << QByteArray() << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+    QTest::newRow("marker only") << QByteArray(">") << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+    QTest::newRow("marker at end") << QByteArray(">12 3 456 789 10>") << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+    QTest::newRow("four fields") << QByteArray(">12 3 456 789") << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+    QTest::newRow("four fields, blank") << QByteArray(">12 3 456 789 \r") << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+    QTest::newRow("non-digit token") << QByteArray(">12 3 abc 789 10") << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+    QTest::newRow("letter after digits") << QByteArray(">12 3 4x 789 10") << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+    QTest::newRow("negative value") << QByteArray(">12 3 -456 789 10") << false << (quint16)0 << (quint16)0 << (quint64)0 << (quint64)0;
+}
+
+void TestWireCodec::testDecodeText()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(bool, valid);
+    QFETCH(quint16, signalId);
+    QFETCH(quint16, packetNumber);
+    QFETCH(quint64, rawValue);
+    QFETCH(quint64, timestamp);
+
+    VisuDatagram datagram = {};
+    QCOMPARE(VisuWireCodec::decodeText(line.constData(), line.constData() + line.size(), datagram), valid);
+    if (valid)
+    {
+        QCOMPARE(datagram.signalId, signalId);
+        QCOMPARE(datagram.packetNumber, packetNumber);
+        QCOMPARE(datagram.rawValue, rawValue);
+        QCOMPARE(datagram.timestamp, timestamp);
+        QCOMPARE(datagram.checksum, (quint8)10);
+    }
+}
+
+void TestWireCodec::testCobsRoundTrip_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("single zero") << QByteArray(1, 0x0);
+    QTest::newRow("zero run") << QByteArray(10, 0x0);
+    QTest::newRow("zeros around data") << QByteArray("\0\0ab\0c\0\0", 8);
+    QTest::newRow("trailing zero") << QByteArray("abc\0", 4);
+    QTest::newRow("254 non-zero") << QByteArray(254, 'x');
+    QTest::newRow("254 non-zero, zero") << QByteArray(254, 'x').append('\0');
+    QTest::newRow("255 non-zero") << QByteArray(255, 'x');
+    QTest::newRow("508 non-zero") << QByteArray(508, 'x');
+    QTest::newRow("508 non-zero, zero") << QByteArray(508, 'x').append('\0');
+    QTest::newRow("253 non-zero, zero, 300 non-zero") << QByteArray(253, 'x').append('\0').append(QByteArray(300, 'y'));
+}
+
+void TestWireCodec::testCobsRoundTrip()
+{
+    QFETCH(QByteArray, data);
+    const quint8* bytes = (const quint8*)data.constData();
+
+    QVector<quint8> encoded(VisuWireCodec::getCobsMaxSize(data.size()));
+    int size = VisuWireCodec::encodeCobs(bytes, data.size(), encoded.data());
+    QVERIFY(size > 0);
+    QVERIFY(size <= encoded.size());
+    for (int i = 0; i < size; ++i)
+    {
+        QVERIFY(encoded[i] != 0x0);
+    }
+
+    QVector<quint8> decoded(size);
+    QCOMPARE(VisuWireCodec::decodeCobs(encoded.constData(), size, decoded.data()), data.size());
+    QVERIFY(memcmp(decoded.constData(), bytes, data.size()) == 0);
+}
+
+void TestWireCodec::testCobsRejected_data()
+{
+    QTest::addColumn<QByteArray>("encoded");
+
+    QTest::newRow("code past end") << QByteArray("\x05ab", 3);
+    QTest::newRow("code past end after block") << QByteArray("\x02a\x03b", 4);
+    QTest::newRow("zero code") << QByteArray("\x02a\0", 3);
+    QTest::newRow("zero in block") << QByteArray("\x04a\0b", 4);
+}
+
+void TestWireCodec::testCobsRejected()
+{
+    QFETCH(QByteArray, encoded);
+
+    QVector<quint8> decoded(encoded.size());
+    QCOMPARE(VisuWireCodec::decodeCobs((const quint8*)encoded.constData(), encoded.size(), decoded.data()), -1);
+}
+
+QTEST_APPLESS_MAIN(TestWireCodec)
+
+#include "tst_wirecodec.moc"
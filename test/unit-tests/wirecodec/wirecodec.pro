@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Wire codec unit tests
+#
+#-------------------------------------------------
+
+QT       += testlib
+QT       -= gui
+
+QMAKE_CXXFLAGS += -std=c++0x
+
+TARGET = tst_wirecodec
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../../includes
+
+SOURCES += tst_wirecodec.cpp \
+    ../../../src/visuwirecodec.cpp \
+    ../../../src/visudatagram.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"